@@ -0,0 +1,66 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace workflow {
+
+using ByteArray = std::vector<uint8_t>;
+/** @brief Immutable buffer that holds a text or byte array value. */
+using SharedBuffer = std::shared_ptr<const ByteArray>;
+
+/**
+ * @class BufferPool
+ *
+ * @brief Recycles the memory of shared byte buffers.
+ *
+ * A buffer from the pool returns its memory to the pool when the last
+ * reference is released, instead of freeing it. Parameters that are set
+ * with frames of the same size at a high rate then reuse a few buffers
+ * instead of allocating a new buffer for each frame. Buffers may outlive
+ * the pool.
+ */
+class BufferPool {
+ public:
+  /**
+   * @brief Creates a pool.
+   * @param max_buffers Maximum number of free buffers that are kept.
+   */
+  explicit BufferPool(size_t max_buffers = 16);
+  virtual ~BufferPool() = default;
+
+  BufferPool(const BufferPool& pool) = delete;
+  BufferPool& operator = (const BufferPool& pool) = delete;
+
+  /** @brief Pool that is used by the parameters. */
+  [[nodiscard]] static BufferPool& Default();
+
+  /**
+   * @brief Returns a buffer with a size.
+   *
+   * The content of a reused buffer is undefined. The buffer is filled by
+   * the caller and then shared as an immutable SharedBuffer.
+   * @param size Size of the buffer.
+   * @return Buffer that returns to the pool when released.
+   */
+  [[nodiscard]] std::shared_ptr<ByteArray> Acquire(size_t size);
+
+  /** @brief Copies data into a buffer from the pool. */
+  [[nodiscard]] SharedBuffer Copy(const uint8_t* data, size_t size);
+
+  [[nodiscard]] size_t MaxBuffers() const;
+  [[nodiscard]] size_t NofFree() const;
+  [[nodiscard]] uint64_t NofAllocations() const;
+  [[nodiscard]] uint64_t NofReuses() const;
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_; ///< Shared with the buffer deleters
+};
+
+}  // namespace workflow
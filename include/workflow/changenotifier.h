@@ -0,0 +1,134 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "workflow/parameter.h"
+
+namespace workflow {
+
+class WorkflowQueue;
+
+/**
+ * @class ChangeNotifier
+ *
+ * @brief Delivers batched parameter change notifications.
+ *
+ * A parameter reports a change to the notifier the first time its value is
+ * set after the last dispatch. Later changes in the same cycle are
+ * coalesced, so a burst of writes results in a single notification.
+ *
+ * The Dispatch() function is called once per cycle, normally by the
+ * container Tick() function. Each subscriber then gets one change list
+ * with the parameters it subscribes to. The list is either delivered by a
+ * callback in the dispatch thread, or pushed onto a queue, so it can be
+ * handled by a queue event in another thread.
+ */
+class ChangeNotifier {
+ public:
+  ChangeNotifier() = default;
+  virtual ~ChangeNotifier() = default;
+
+  ChangeNotifier(const ChangeNotifier& notifier) = delete;
+  ChangeNotifier& operator = (const ChangeNotifier& notifier) = delete;
+
+  /**
+   * @brief Subscribes on parameter changes.
+   * @param callback Function that is called with the changed parameters.
+   * @param filter Parameters to subscribe on. Empty list means all.
+   * @return Subscription identity.
+   */
+  size_t Subscribe(ChangeCallback callback, const ChangeList& filter = {});
+
+  /**
+   * @brief Subscribes on parameter changes with queue delivery.
+   *
+   * A ChangeList item is pushed onto the queue each dispatch cycle that
+   * has changes.
+   * @param queue Destination queue.
+   * @param filter Parameters to subscribe on. Empty list means all.
+   * @return Subscription identity.
+   */
+  size_t Subscribe(WorkflowQueue& queue, const ChangeList& filter = {});
+
+  /**
+   * @brief Removes a subscription.
+   *
+   * The function may be called from a subscriber callback. The removed
+   * subscriber isn't called after the function returns. If its callback is
+   * running in another thread, the function waits until it returns, so a
+   * callback shall not unsubscribe a subscriber that is called at the same
+   * time by another thread.
+   * @param subscription Subscription identity.
+   */
+  void Unsubscribe(size_t subscription);
+
+  /** @brief Returns true if there are any subscribers. */
+  [[nodiscard]] bool Active() const {
+    return nof_subscribers_.load(std::memory_order_relaxed) > 0;
+  }
+
+  /** @brief Reports a changed parameter. Called by the parameter. */
+  void Changed(Parameter& parameter);
+
+  /**
+   * @brief Collects the changes in this thread until EndBatch().
+   *
+   * The collected changes are queued in one step by EndBatch(), so they
+   * are always dispatched in the same cycle. Batches may be nested, also
+   * between notifiers. An inner batch on the same notifier is added to the
+   * outer batch when it ends.
+   */
+  void BeginBatch();
+  void EndBatch();
+
+  /** @brief Removes a parameter that is about to be deleted. */
+  void Remove(const Parameter* parameter);
+
+  /**
+   * @brief Notifies the subscribers about all changes since the last call.
+   * @return Number of notifications.
+   */
+  size_t Dispatch();
+
+  [[nodiscard]] uint64_t NofChanges() const { return nof_changes_; }
+  [[nodiscard]] uint64_t NofNotifications() const {
+    return nof_notifications_;
+  }
+
+ private:
+  struct Subscriber {
+    size_t subscription = 0;
+    ChangeCallback callback;
+    WorkflowQueue* queue = nullptr;
+    std::set<const Parameter*> filter;
+    std::atomic<bool> active = true;
+    std::mutex call_lock; ///< Held while the callback runs
+  };
+  using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+  std::mutex change_lock_;
+  ChangeList change_list_; ///< Parameters changed since last dispatch
+
+  /// The callbacks are called without the lock, so a callback may
+  /// subscribe and unsubscribe.
+  mutable std::mutex subscriber_lock_;
+  SubscriberList subscriber_list_;
+  size_t last_subscription_ = 0;
+  std::atomic<size_t> nof_subscribers_ = 0;
+
+  std::atomic<uint64_t> nof_changes_ = 0;
+  std::atomic<uint64_t> nof_notifications_ = 0;
+
+  size_t AddSubscriber(std::shared_ptr<Subscriber> subscriber);
+};
+
+}  // namespace workflow
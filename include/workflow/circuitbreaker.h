@@ -0,0 +1,123 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+
+namespace util::xml {
+
+class IXmlNode;
+
+} // end namespace util::xml
+
+namespace workflow {
+
+/**
+ * @enum CircuitState
+ *
+ * @brief State of a task circuit breaker.
+ *
+ * - Closed: The task is ticked normally.
+ * - Open: The task has failed too many times and is not ticked until the
+ * backoff time has expired.
+ * - HalfOpen: The backoff time has expired and the next tick is a probe. A
+ * successful probe closes the circuit, a failed probe opens it again with a
+ * longer backoff time.
+ */
+enum class CircuitState : int {
+  Closed = 0,
+  Open,
+  HalfOpen
+};
+
+/**
+ * @brief Recorded change of a circuit breaker state.
+ */
+struct CircuitTransition {
+  uint64_t time = 0; ///< Monotonic time of the transition (ns).
+  CircuitState from = CircuitState::Closed; ///< Previous state.
+  CircuitState to = CircuitState::Closed; ///< New state.
+  size_t failures = 0; ///< Consecutive failures at the transition.
+};
+
+/**
+ * @class CircuitBreaker
+ *
+ * @brief Stops a failing task from being retried on every workflow tick.
+ *
+ * The breaker counts consecutive failures of a task. When the count reaches
+ * MaxFailures(), the circuit opens and the task is skipped for a backoff time.
+ * The backoff time starts at MinBackoff() and doubles for each failed probe
+ * up to MaxBackoff(). A random jitter is added so tasks that failed at the
+ * same time, don't retry at the same time.
+ *
+ * A MaxFailures() value of 0 disables the breaker, which is the default.
+ * Only the configuration is copied and compared. The run-time state is reset
+ * on copy.
+ */
+class CircuitBreaker {
+ public:
+  CircuitBreaker() = default;
+  CircuitBreaker(const CircuitBreaker& breaker);
+  CircuitBreaker& operator = (const CircuitBreaker& breaker);
+  [[nodiscard]] bool operator == (const CircuitBreaker& breaker) const;
+
+  void MaxFailures(size_t max_failures) { max_failures_ = max_failures; }
+  [[nodiscard]] size_t MaxFailures() const { return max_failures_; }
+
+  void MinBackoff(double backoff) { min_backoff_ = backoff; }
+  [[nodiscard]] double MinBackoff() const { return min_backoff_; } ///< Seconds
+
+  void MaxBackoff(double backoff) { max_backoff_ = backoff; }
+  [[nodiscard]] double MaxBackoff() const { return max_backoff_; } ///< Seconds
+
+  void Jitter(double jitter) { jitter_ = jitter; }
+  [[nodiscard]] double Jitter() const { return jitter_; } ///< Fraction 0..1
+
+  [[nodiscard]] bool Enabled() const { return max_failures_ > 0; }
+  [[nodiscard]] CircuitState State() const { return state_; }
+  [[nodiscard]] std::string StateAsString() const;
+  [[nodiscard]] size_t Failures() const { return failures_; }
+  [[nodiscard]] uint64_t NextProbe() const { return next_probe_; }
+
+  [[nodiscard]] const std::vector<CircuitTransition>& Transitions() const {
+    return transition_list_;
+  }
+
+  /**
+   * @brief Returns true if the task should be ticked at this time.
+   *
+   * All times are monotonic times in ns, see ITask::SteadyTime(), so a
+   * change of the system clock doesn't affect the backoff.
+   */
+  [[nodiscard]] bool AllowTick(uint64_t now);
+  void Success(uint64_t now);
+  void Failure(uint64_t now);
+  void Reset();
+
+  void SaveXml(util::xml::IXmlNode& root) const;
+  void ReadXml(const util::xml::IXmlNode& root);
+
+ private:
+  size_t max_failures_ = 0; ///< Number of failures before open. 0 = disabled.
+  double min_backoff_ = 1.0; ///< First backoff time (s).
+  double max_backoff_ = 300.0; ///< Maximum backoff time (s).
+  double jitter_ = 0.1; ///< Random +/- fraction of the backoff time.
+
+  CircuitState state_ = CircuitState::Closed;
+  size_t failures_ = 0; ///< Consecutive failures.
+  size_t nof_opens_ = 0; ///< Consecutive opens. Used for the backoff.
+  uint64_t next_probe_ = 0; ///< Time of next half-open probe (ns).
+  std::vector<CircuitTransition> transition_list_;
+  std::minstd_rand random_ {std::random_device{}()};
+
+  void ChangeState(CircuitState state, uint64_t now);
+  void Open(uint64_t now);
+};
+
+}  // namespace workflow
@@ -0,0 +1,91 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace workflow {
+
+/**
+ * @class ConfigArena
+ *
+ * @brief Arena for the configuration objects of a workflow server.
+ *
+ * The arena allocates memory from a few large blocks (monotonic buffer
+ * resource). The workflow, task, event, device and parameter objects take
+ * their memory from the arena if they are created while an arena scope
+ * (ConfigArenaScope) is active in the thread. Otherwise, they are allocated
+ * on the heap as normal.
+ *
+ * Deleting an arena object doesn't free any memory. All memory is freed at
+ * once by Release(), when all arena objects have been deleted.
+ *
+ * Only one thread at a time may have a scope on the same arena.
+ */
+class ConfigArena {
+ public:
+  ConfigArena() = default;
+  virtual ~ConfigArena() = default;
+
+  ConfigArena(const ConfigArena& arena) = delete;
+  ConfigArena& operator = (const ConfigArena& arena) = delete;
+
+  /** @brief Number of arena objects that are not deleted. */
+  [[nodiscard]] size_t NofObjects() const { return nof_objects_; }
+  /** @brief Number of bytes allocated since the last release. */
+  [[nodiscard]] size_t NofBytes() const { return nof_bytes_; }
+
+  /**
+   * @brief Frees all arena memory.
+   *
+   * The memory is only freed if all arena objects have been deleted.
+   * @return True if the memory was freed.
+   */
+  bool Release();
+
+  /**
+   * @brief Allocates memory for an object.
+   *
+   * Allocates from the active arena in this thread, or from the heap if no
+   * arena is active. Used by the class-specific operator new functions.
+   * @param size Size of the object.
+   * @return Pointer to the object memory.
+   */
+  [[nodiscard]] static void* Allocate(size_t size);
+  static void Deallocate(void* object) noexcept;
+
+  /** @brief Returns the active arena in this thread (may be null). */
+  [[nodiscard]] static ConfigArena* Current();
+
+ private:
+  friend class ConfigArenaScope;
+
+  std::pmr::monotonic_buffer_resource resource_;
+  std::atomic<size_t> nof_objects_ = 0;
+  std::atomic<size_t> nof_bytes_ = 0;
+};
+
+/**
+ * @class ConfigArenaScope
+ *
+ * @brief Activates an arena in the current thread during its lifetime.
+ *
+ * A null arena deactivates the arena mode. Scopes may be nested.
+ */
+class ConfigArenaScope {
+ public:
+  explicit ConfigArenaScope(ConfigArena* arena);
+  ~ConfigArenaScope();
+
+  ConfigArenaScope(const ConfigArenaScope& scope) = delete;
+  ConfigArenaScope& operator = (const ConfigArenaScope& scope) = delete;
+
+ private:
+  ConfigArena* previous_ = nullptr;
+};
+
+}  // namespace workflow
@@ -0,0 +1,158 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <any>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+
+namespace workflow {
+
+/**
+ * @class CheckpointWriter
+ *
+ * @brief Writes values to a binary checkpoint.
+ *
+ * Numbers are stored in host byte order. Strings are stored with a 32-bit
+ * length.
+ */
+class CheckpointWriter {
+ public:
+  explicit CheckpointWriter(std::ostream& stream) : stream_(stream) {}
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_arithmetic_v<T>, "Only numbers can be written");
+    stream_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  void Write(const std::string& value);
+
+  [[nodiscard]] bool IsOk() const { return stream_.good(); }
+
+ private:
+  std::ostream& stream_;
+};
+
+/**
+ * @class CheckpointReader
+ *
+ * @brief Reads values from a binary checkpoint.
+ */
+class CheckpointReader {
+ public:
+  explicit CheckpointReader(std::istream& stream) : stream_(stream) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    static_assert(std::is_arithmetic_v<T>, "Only numbers can be read");
+    stream_.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream_.good();
+  }
+  bool Read(std::string& value);
+
+  [[nodiscard]] bool IsOk() const { return stream_.good(); }
+
+ private:
+  std::istream& stream_;
+};
+
+/**
+ * @class DataCheckpoint
+ *
+ * @brief Saves and restores workflow data to binary checkpoint files.
+ *
+ * Only data types that are registered can be saved. Some basic types are
+ * registered by default (std::string, std::vector<std::string>, int,
+ * int64_t, uint64_t, double and bool) together with the data of the
+ * syslog tasks (SyslogMessage and SyslogList). The structured data of a
+ * syslog message is not saved. The directory data (IDirectory) is not
+ * registered, as its scanned files cannot be saved. The application
+ * registers its own workflow data types with RegisterType().
+ *
+ * The checkpoint file holds a header with the type name, so the right type
+ * is created on restore. The file is first written to a temporary file and
+ * then renamed, so a crash never leaves a half written checkpoint.
+ */
+class DataCheckpoint {
+ public:
+  template <typename T>
+  using WriteFunction = std::function<void(const T& data,
+                                           CheckpointWriter& writer)>;
+  template <typename T>
+  using ReadFunction = std::function<bool(CheckpointReader& reader,
+                                          T& data)>;
+
+  static DataCheckpoint& Instance();
+
+  /**
+   * @brief Registers a workflow data type.
+   * @tparam T Data type.
+   * @param name Unique type name that is stored in the checkpoint.
+   * @param write Function that writes the data.
+   * @param read Function that reads the data.
+   */
+  template <typename T>
+  void RegisterType(const std::string& name, WriteFunction<T> write,
+                    ReadFunction<T> read);
+
+  [[nodiscard]] bool IsRegistered(const std::any& data) const;
+
+  /**
+   * @brief Saves the data into a checkpoint file.
+   * @param data Workflow data.
+   * @param filename Full path to the checkpoint file.
+   * @param error Error text if the function fails.
+   * @return True on success.
+   */
+  bool Save(const std::any& data, const std::string& filename,
+            std::string& error) const;
+  bool Restore(const std::string& filename, std::any& data,
+               std::string& error) const;
+
+ private:
+  struct Codec {
+    std::string name;
+    std::function<void(const std::any&, CheckpointWriter&)> write;
+    std::function<bool(CheckpointReader&, std::any&)> read;
+  };
+
+  DataCheckpoint();
+
+  mutable std::mutex codec_lock_;
+  std::map<std::type_index, Codec> codec_list_;
+  std::map<std::string, std::type_index> name_list_;
+};
+
+template <typename T>
+void DataCheckpoint::RegisterType(const std::string& name,
+                                  WriteFunction<T> write,
+                                  ReadFunction<T> read) {
+  Codec codec;
+  codec.name = name;
+  codec.write = [write] (const std::any& data, CheckpointWriter& writer) {
+    write(std::any_cast<const T&>(data), writer);
+  };
+  codec.read = [read] (CheckpointReader& reader, std::any& data) {
+    T value {};
+    if (!read(reader, value)) {
+      return false;
+    }
+    data = std::make_any<T>(std::move(value));
+    return true;
+  };
+
+  std::scoped_lock lock(codec_lock_);
+  codec_list_.insert_or_assign(std::type_index(typeid(T)), std::move(codec));
+  name_list_.insert_or_assign(name, std::type_index(typeid(T)));
+}
+
+}  // namespace workflow
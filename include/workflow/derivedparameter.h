@@ -0,0 +1,92 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "workflow/parameter.h"
+#include "workflow/parameterexpression.h"
+
+namespace workflow {
+
+class ParameterContainer;
+
+/**
+ * @class DerivedParameter
+ *
+ * @brief Parameter that is calculated from other parameters.
+ *
+ * The value is defined by the Expression() formula over other parameters
+ * in the same container. The formula is compiled by Init(). The value is
+ * only calculated when it is read and any of the parameters in the formula
+ * changed since the last calculation. A derived parameter may use other
+ * derived parameters but not itself.
+ *
+ * A calculation updates the version of the parameter but it isn't reported
+ * as a change, time stamped or added to the history, so readers don't
+ * generate change events. Subscribe on the input parameters instead.
+ *
+ * Parameter names in the formula are first searched for in the device of
+ * the derived parameter. A name as Device.Name is searched for in that
+ * device.
+ */
+class DerivedParameter : public Parameter {
+ public:
+  explicit DerivedParameter(const ParameterContainer* container = nullptr);
+  DerivedParameter(const DerivedParameter& parameter);
+
+  void Container(const ParameterContainer* container) {
+    container_ = container;
+  }
+
+  /**
+   * @brief Compiles the formula.
+   *
+   * Called by Init(). Fails if the formula is invalid, uses an unknown
+   * parameter or has a circular reference.
+   * @return True if the formula was compiled.
+   */
+  bool Compile();
+  [[nodiscard]] bool IsOk() const { return expression_.IsOk(); }
+  [[nodiscard]] const std::string& LastError() const { return last_error_; }
+
+  [[nodiscard]] const ParameterExpression& Program() const {
+    return expression_;
+  }
+  /** @brief Number of times the formula has been calculated. */
+  [[nodiscard]] uint64_t NofEvaluations() const { return nof_evaluations_; }
+
+  /**
+   * @brief Sum of the versions of the parameters in the formula.
+   *
+   * Derived parameters in the formula contribute with their own input
+   * version, so a change is detected without calculating them.
+   */
+  [[nodiscard]] uint64_t InputVersion() const override;
+
+  void Init() override;
+
+ protected:
+  void OnGetValue() override;
+
+ private:
+  static constexpr uint64_t kNotEvaluated = UINT64_MAX;
+
+  const ParameterContainer* container_ = nullptr;
+  ParameterExpression expression_; ///< Compiled formula
+  std::string last_error_;
+  /// Derived parameters in the formula. Null for other parameters.
+  std::vector<const DerivedParameter*> derived_list_;
+  std::atomic<uint64_t> evaluated_version_ = kNotEvaluated;
+  std::atomic<uint64_t> nof_evaluations_ = 0;
+  std::mutex evaluate_lock_; ///< Only one thread calculates the value
+
+  [[nodiscard]] bool DependsOn(const DerivedParameter* parameter) const;
+};
+
+}  // namespace workflow
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <string>
+#include "workflow/configarena.h"
 
 namespace util::xml {
 
@@ -16,6 +17,13 @@ namespace workflow {
 
 class Device {
  public:
+  static void* operator new(size_t size) {
+    return ConfigArena::Allocate(size);
+  }
+  static void operator delete(void* object) {
+    ConfigArena::Deallocate(object);
+  }
+
   [[nodiscard]] bool operator == (const Device& device) const = default;
   [[nodiscard]] bool operator < (const Device& device) const;
 
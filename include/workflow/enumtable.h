@@ -0,0 +1,83 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace workflow {
+
+using EnumList = std::map<int64_t, std::string>;
+
+/**
+ * @class EnumTable
+ *
+ * @brief Immutable lookup table between enumerate values and names.
+ *
+ * Both name to value and value to name are hash or array lookups. Tables
+ * are interned. Parameters with the same enumerate definition share one
+ * table, so equal definitions also have equal table pointers.
+ */
+class EnumTable {
+ public:
+  explicit EnumTable(EnumList enum_list);
+  virtual ~EnumTable() = default;
+
+  EnumTable(const EnumTable& table) = delete;
+  EnumTable& operator = (const EnumTable& table) = delete;
+
+  /**
+   * @brief Returns the shared table for an enumerate definition.
+   * @param enum_list Enumerate values and names.
+   * @return Shared table or null if the list is empty.
+   */
+  [[nodiscard]] static std::shared_ptr<const EnumTable> Intern(
+      const EnumList& enum_list);
+  /** @brief Number of interned tables that are in use. */
+  [[nodiscard]] static size_t NofInterned();
+
+  [[nodiscard]] const EnumList& List() const { return enum_list_; }
+  [[nodiscard]] size_t Size() const { return enum_list_.size(); }
+
+  /**
+   * @brief Returns the name of a value.
+   * @param value Enumerate value.
+   * @return Name or null if the value is not defined.
+   */
+  [[nodiscard]] const std::string* Name(int64_t value) const;
+
+  /**
+   * @brief Returns the value of a name.
+   * @param name Enumerate name. Case sensitive.
+   * @param value Enumerate value.
+   * @return False if the name is not defined.
+   */
+  [[nodiscard]] bool Value(std::string_view name, int64_t& value) const;
+
+ private:
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+      return std::hash<std::string_view>{}(name);
+    }
+  };
+
+  EnumList enum_list_;
+  std::unordered_map<std::string, int64_t, NameHash, std::equal_to<>>
+      value_index_; ///< Name to value
+  /// Value to name if the values are dense, indexed by value - first value.
+  std::vector<const std::string*> name_array_;
+  int64_t first_value_ = 0;
+  /// Value to name if the values are sparse.
+  std::unordered_map<int64_t, const std::string*> name_index_;
+};
+
+}  // namespace workflow
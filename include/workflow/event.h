@@ -11,12 +11,13 @@
 #include <thread>
 
 #include "workflow/itask.h"
+#include "workflow/configarena.h"
 #include <util/ixmlnode.h>
 
 namespace workflow {
 
 class Workflow;
-
+class WorkflowQueue;
 
 /**
  * @enum EventType
@@ -33,6 +34,7 @@ class Workflow;
  * - Cyclic: The cyclic event.
  * - Periodic: The periodic event.
  * - Parameter: The parameter event.
+ * - Queue: The queue event.
  */
 enum class EventType {
   Init,
@@ -40,6 +42,7 @@ enum class EventType {
   Cyclic,
   Periodic,
   Parameter,
+  Queue,
 };
 
 /**
@@ -56,6 +59,12 @@ class Event {
  public:
   Event() = default; ///< Default constructor
   virtual ~Event();  ///< Destructor
+  static void* operator new(size_t size) {
+    return ConfigArena::Allocate(size);
+  }
+  static void operator delete(void* object) {
+    ConfigArena::Deallocate(object);
+  }
   Event(const Event& event); ///< Default copy constructor
   [[nodiscard]] bool operator == (const Event& event) const; ///< Compares 2 events
 
@@ -122,6 +131,11 @@ class Event {
    * The EventTYpe::Parameter is triggered by a parameter in the workflow parameter area.
    * The parameter should be a so-called event parameter (value: 0 or 1).
    *
+   * The EventType::Queue is triggered when the workflow queue, named by the
+   * Parameter() property, has items. The attached workflows are ticked in the
+   * event thread until the queue is empty, so the workflow should have a task
+   * that pops the items.
+   *
    * @param type The type of the event.
    *
    * @returns None.
@@ -181,6 +195,9 @@ class Event {
   void AttachWorkflow(Workflow* workflow);
   void DetachWorkflows();
 
+  void AttachQueue(WorkflowQueue* queue) {queue_ = queue;}
+  [[nodiscard]] WorkflowQueue* GetQueue() const {return queue_;}
+
  protected:
 
  private:
@@ -190,6 +207,7 @@ class Event {
   uint64_t period_ = 1000; ///< Period in ms
   EventType type_ = EventType::Cyclic;
   std::vector<Workflow*> workflow_list_;
+  WorkflowQueue* queue_ = nullptr; ///< Queue that triggers a queue event
 
   std::thread working_thread_;
   std::atomic<bool> stop_thread_ = true;
@@ -198,6 +216,8 @@ class Event {
 
   void PeriodicTask();
   void CyclicTask();
+  void QueueTask();
+  void StopThread();
 };
 
 }  // namespace workflow
@@ -4,12 +4,18 @@
  */
 
 #pragma once
+#include <cstdint>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <any>
 #include <map>
+#include <memory>
 #include <sstream>
 #include "workflow/parameter.h"
+#include "workflow/circuitbreaker.h"
+#include "workflow/configarena.h"
+#include "workflow/nameindex.h"
 #include <util/idirectory.h>
 
 namespace workflow {
@@ -27,13 +33,37 @@ enum class TaskType : int {
 
 class ITask {
  public:
+  /** @brief Input version of a task that hasn't run yet. */
+  static constexpr uint64_t kNoInputVersion = UINT64_MAX;
+
   ITask() = default;
   ITask(const ITask& source);
   virtual ~ITask() = default;
+  static void* operator new(size_t size) {
+    return ConfigArena::Allocate(size);
+  }
+  static void operator delete(void* object) {
+    ConfigArena::Deallocate(object);
+  }
 
   [[nodiscard]] bool operator==(const ITask& runner) const;
 
-  void Name(const std::string& name) { name_ = name; }
+  /**
+   * @brief Returns a copy of the task with the same task type.
+   *
+   * The copy holds the configuration and the parsed arguments of the task
+   * but none of its runtime resources. Derived tasks shall override the
+   * function, otherwise the copy is a plain ITask.
+   * @return A new task object.
+   */
+  [[nodiscard]] virtual std::unique_ptr<ITask> Clone() const;
+
+  void Name(const std::string& name) {
+    if (name_ != name) {
+      name_ = name;
+      NameIndex::NameChanged();
+    }
+  }
   [[nodiscard]] const std::string& Name() const { return name_; }
 
   void Description(const std::string& desc) { description_ = desc; }
@@ -71,6 +101,52 @@ class ITask {
   void LastError(const std::string& error) {last_error_ = error; }
   [[nodiscard]] const std::string& LastError() const { return last_error_; }
 
+  /**
+   * @brief Declares that the task reads the workflow data.
+   *
+   * The task inputs are the parameters in the Parameters() list and,
+   * if this flag is set, the workflow data. The inputs are used by an
+   * incremental workflow to skip tasks whose inputs hasn't changed.
+   * @param reads_data True if the task reads the workflow data.
+   */
+  void ReadsData(bool reads_data) { reads_data_ = reads_data; }
+  [[nodiscard]] bool ReadsData() const { return reads_data_; }
+  [[nodiscard]] bool HasInputs() const;
+  [[nodiscard]] uint64_t InputVersion() const;
+
+  void LastInputVersion(uint64_t version) { last_input_version_ = version; }
+  [[nodiscard]] uint64_t LastInputVersion() const {
+    return last_input_version_;
+  }
+
+  [[nodiscard]] CircuitBreaker& Breaker() { return breaker_; }
+  [[nodiscard]] const CircuitBreaker& Breaker() const { return breaker_; }
+
+  /**
+   * @brief Maximum time for one Tick() call.
+   *
+   * The watchdog marks the task as stalled if a Tick() call takes longer
+   * than the timeout. A zero timeout disables the check.
+   * @param timeout Timeout in seconds.
+   */
+  void Timeout(double timeout) { timeout_ = timeout; }
+  [[nodiscard]] double Timeout() const { return timeout_; }
+
+  /**
+   * @brief Monotonic time in ns for tick durations and backoff times.
+   *
+   * The time is not affected by changes of the system clock, so a clock
+   * adjustment doesn't give false stalls or skip a backoff.
+   */
+  [[nodiscard]] static uint64_t SteadyTime();
+
+  void TickStarted(uint64_t now); ///< Monotonic time (ns). See SteadyTime().
+  void TickStopped(uint64_t now); ///< Monotonic time (ns). See SteadyTime().
+  [[nodiscard]] bool CheckTimeout(uint64_t now);
+  [[nodiscard]] bool Stalled() const { return stalled_; }
+  [[nodiscard]] uint64_t StallDuration() const { return stall_duration_; }
+  [[nodiscard]] size_t TickThread() const { return tick_thread_; }
+
   virtual void Init();
   virtual void Tick();
   virtual void Exit();
@@ -82,7 +158,12 @@ class ITask {
 
  protected:
 
-  void Template(const std::string& template_name) {template_ = template_name;}
+  void Template(const std::string& template_name) {
+    if (template_ != template_name) {
+      template_ = template_name;
+      NameIndex::NameChanged();
+    }
+  }
 
   [[nodiscard]] Workflow* GetWorkflow() {return workflow_;}
   [[nodiscard]] const ITask* GetTaskByTemplateName(const std::string& name) const;
@@ -99,7 +180,15 @@ class ITask {
   bool is_ok_ = false; ///< Indicate a run-time failure
   Workflow* workflow_ = nullptr; ///< Internal reference to its workflow
   std::string template_; ///< Internal reference to template
-
+  CircuitBreaker breaker_; ///< Backoff of failing tasks
+  bool reads_data_ = false; ///< The task reads the workflow data
+  uint64_t last_input_version_ = kNoInputVersion; ///< Inputs at last run
+
+  double timeout_ = 0; ///< Tick timeout in seconds. 0 = no timeout.
+  std::atomic<uint64_t> tick_start_ = 0; ///< Start of current tick (ns)
+  std::atomic<size_t> tick_thread_ = 0; ///< Hash of the tick thread ID
+  std::atomic<bool> stalled_ = false; ///< Tick exceeded the timeout
+  std::atomic<uint64_t> stall_duration_ = 0; ///< Duration of stall (ns)
 
 };
 
@@ -0,0 +1,87 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace workflow {
+
+/**
+ * @class NameIndex
+ *
+ * @brief Case-insensitive hash index from a name to a list position.
+ *
+ * The index is used to find tasks and workflows by name without scanning
+ * the list. The owner rebuilds the index each time it changes the list. The
+ * caller shall verify that the item at the returned position has the name,
+ * as the list or the name may have been changed directly.
+ *
+ * A miss is final unless the index is stale. The index is stale when any
+ * task or workflow has been renamed since it was built, or when the owner
+ * has invalidated it, because its list may have been changed directly. A
+ * stale miss shall be checked by scanning the list.
+ *
+ * The lookup doesn't allocate any memory, as the names are hashed and
+ * compared without case folding them into a new string.
+ */
+class NameIndex {
+ public:
+  static constexpr size_t kNotFound = SIZE_MAX;
+
+  NameIndex() = default;
+  NameIndex(const NameIndex& index);
+  NameIndex& operator=(const NameIndex& index);
+
+  /** @brief Clears the index and marks it as up to date. */
+  void Clear();
+  /** @brief Marks the index as stale, as the list may be changed directly. */
+  void Invalidate() { generation_ = 0; }
+  /** @brief Returns true if a name or the list may have changed. */
+  [[nodiscard]] bool Stale() const {
+    return generation_ != name_generation_;
+  }
+  /** @brief Marks all indexes as stale. Called by the name setters. */
+  static void NameChanged() { ++name_generation_; }
+
+  [[nodiscard]] bool Empty() const { return index_list_.empty(); }
+  [[nodiscard]] size_t Size() const { return index_list_.size(); }
+
+  /**
+   * @brief Adds a name to the index.
+   *
+   * If the name already exists, the first position is kept. This is the same
+   * item as a linear search would find.
+   * @param name Name of the item.
+   * @param index Position in the list.
+   */
+  void Add(std::string_view name, size_t index);
+  [[nodiscard]] size_t Find(std::string_view name) const;
+
+  [[nodiscard]] static std::string Fold(std::string_view name);
+
+ private:
+  /** @brief Case-insensitive hash that accepts any string type. */
+  struct FoldHash {
+    using is_transparent = void;
+    [[nodiscard]] size_t operator()(std::string_view name) const;
+  };
+
+  /** @brief Case-insensitive compare that accepts any string type. */
+  struct FoldEqual {
+    using is_transparent = void;
+    [[nodiscard]] bool operator()(std::string_view name1,
+                                  std::string_view name2) const;
+  };
+
+  std::unordered_map<std::string, size_t, FoldHash, FoldEqual> index_list_;
+  std::atomic<uint64_t> generation_ = 0; ///< Name generation when built.
+  static std::atomic<uint64_t> name_generation_; ///< Starts at 1.
+};
+
+}  // namespace workflow
@@ -5,14 +5,27 @@
 
 #pragma once
 #include <cstdint>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 #include <map>
-
-#pragma managed(push, off)
-#include <mutex>
-#pragma managed(pop)
+#include <span>
+#include "workflow/configarena.h"
+#include "workflow/parameterstore.h"
+#include "workflow/parameterhistory.h"
+#include "workflow/enumtable.h"
+#include "workflow/bufferpool.h"
 
 namespace util::xml {
 
@@ -23,7 +36,7 @@ class IXmlNode;
 
 namespace workflow {
 
-enum class ParameterDataType : int {
+enum class ParameterDataType : uint8_t {
   FloatType = 0, ///< 64-bit floating point
   SignedType,
   UnsignedType,
@@ -33,14 +46,72 @@ enum class ParameterDataType : int {
   ByteArrayType,
 };
 
-using ByteArray = std::vector<uint8_t>;
-using EnumList = std::map<int64_t, std::string>;
+class Parameter;
+class ChangeNotifier;
+template <typename T>
+class TypedParameter;
+
+using ByteSpan = std::span<const uint8_t>;
+using ChangeList = std::vector<Parameter*>;
+/** @brief Called with all parameters that changed in a dispatch cycle. */
+using ChangeCallback = std::function<void(const ChangeList& change_list)>;
+
+/**
+ * @brief Descriptive properties of a parameter.
+ *
+ * The properties are seldom used at runtime, so they are stored outside
+ * of the parameter object. They are only allocated if any of them is set.
+ */
+struct ParameterInfo {
+  std::string unit; ///< Unit of measure
+  std::string description; ///< Optional description of the parameter
+  std::string signal; ///< Signal or channel name
+  std::string identity; ///< Free of use but normally external ID
+  std::string display_name; ///< Display name used as label
+  /// Enumerate values. Shared by parameters with the same definition.
+  std::shared_ptr<const EnumTable> enum_table;
+  std::string expression; ///< Formula of a derived parameter
+
+  [[nodiscard]] bool operator == (const ParameterInfo& info) const = default;
+};
+
+/**
+ * @brief Deadband and hysteresis of a numeric parameter.
+ *
+ * A new value is only reported as a change if it differs more than the
+ * band from the last reported value. The band is the largest of the
+ * absolute band and the relative band times the reported value. A change
+ * that reverses the direction of the last reported change shall also pass
+ * the hysteresis.
+ */
+struct ParameterDeadband {
+  double absolute = 0.0; ///< Absolute band
+  double relative = 0.0; ///< Relative band, 0.01 = 1%
+  double hysteresis = 0.0; ///< Extra band when the direction reverses
+
+  // Filter state. Only changed while the parameter holds its write bit.
+  bool reported = false; ///< True if a value has been reported
+  double reference = 0.0; ///< Last reported value
+  int direction = 0; ///< Direction of the last reported change
+  uint64_t nof_suppressed = 0; ///< Number of writes within the band
+
+  [[nodiscard]] bool Empty() const {
+    return absolute <= 0.0 && relative <= 0.0 && hysteresis <= 0.0;
+  }
+};
+
 
 
 class Parameter {
  public:
   Parameter() = default;
   virtual ~Parameter() = default;
+  static void* operator new(size_t size) {
+    return ConfigArena::Allocate(size);
+  }
+  static void operator delete(void* object) {
+    ConfigArena::Deallocate(object);
+  }
 
   Parameter(const Parameter& parameter);
   [[nodiscard]] bool operator == (const Parameter& parameter) const;
@@ -49,44 +120,203 @@ class Parameter {
   [[nodiscard]] const std::string& Name() const { return name_; }
 
   void DisplayName(const std::string& display_name) {
-    display_name_ = display_name;
+    Info().display_name = display_name;
+  }
+  [[nodiscard]] const std::string& DisplayName() const {
+    return info_ ? info_->display_name : kEmptyText;
   }
-  [[nodiscard]] const std::string& DisplayName() const { return display_name_; }
 
   void Description(const std::string& description) {
-    description_ = description;
+    Info().description = description;
+  }
+  [[nodiscard]] const std::string& Description() const {
+    return info_ ? info_->description : kEmptyText;
   }
-  [[nodiscard]] const std::string& Description() const { return description_; }
 
-  void Unit(const std::string& unit) { unit_ = unit; }
-  [[nodiscard]] const std::string& Unit() const { return unit_; }
+  void Unit(const std::string& unit) { Info().unit = unit; }
+  [[nodiscard]] const std::string& Unit() const {
+    return info_ ? info_->unit : kEmptyText;
+  }
 
   void Device(const std::string& device) { device_ = device; }
   [[nodiscard]] const std::string& Device() const { return device_; }
 
-  void Identity(const std::string& identity) { identity_ = identity; }
-  [[nodiscard]] const std::string& Identity() const { return identity_; }
+  void Identity(const std::string& identity) { Info().identity = identity; }
+  [[nodiscard]] const std::string& Identity() const {
+    return info_ ? info_->identity : kEmptyText;
+  }
+
+  void Signal(const std::string& signal) { Info().signal = signal; }
+  [[nodiscard]] const std::string& Signal() const {
+    return info_ ? info_->signal : kEmptyText;
+  }
 
-  void Signal(const std::string& signal) { signal_ = signal; }
-  [[nodiscard]] const std::string& Signal() const { return signal_; }
+  /**
+   * @brief Formula of a derived parameter.
+   *
+   * The formula is only evaluated by a DerivedParameter. It is stored
+   * here, so it follows the parameter configuration.
+   * @param expression Formula text.
+   */
+  void Expression(const std::string& expression) {
+    Info().expression = expression;
+  }
+  [[nodiscard]] const std::string& Expression() const {
+    return info_ ? info_->expression : kEmptyText;
+  }
 
-  void DataType(ParameterDataType type) { data_type_ = type; }
+  void DataType(ParameterDataType type);
   [[nodiscard]] ParameterDataType DataType() const { return data_type_; }
   void DataTypeAsString(const std::string& type);
   [[nodiscard]] std::string DataTypeAsString() const;
 
-  void Enums(const EnumList& enum_list) {enum_list_ = enum_list;}
-  [[nodiscard]] const EnumList& Enums() const {return enum_list_;}
+  void Enums(const EnumList& enum_list) {
+    Info().enum_table = EnumTable::Intern(enum_list);
+  }
+  [[nodiscard]] const EnumList& Enums() const {
+    const auto* enum_table = GetEnumTable();
+    return enum_table != nullptr ? enum_table->List() : kEmptyEnumList;
+  }
+  [[nodiscard]] const EnumTable* GetEnumTable() const {
+    return info_ ? info_->enum_table.get() : nullptr;
+  }
 
   void Valid(bool valid);
   [[nodiscard]] bool Valid() const;
 
+  /** @brief Monotonic time in ns when the value was last set. */
+  [[nodiscard]] uint64_t Timestamp() const {
+    return slot_.timestamp.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Keeps the latest values in a history buffer.
+   *
+   * Each set value is added to the buffer as a double together with its
+   * timestamp. Text values use their numeric value. A size of 0 removes
+   * the buffer. Shall not be called while the value is accessed by other
+   * threads.
+   * @param size Number of values to keep.
+   */
+  void HistorySize(size_t size);
+  [[nodiscard]] size_t HistorySize() const {
+    return history_ ? history_->Capacity() : 0;
+  }
+  [[nodiscard]] const ParameterHistory* History() const {
+    return history_.get();
+  }
+
+  /**
+   * @brief Sets the deadband of a numeric parameter.
+   *
+   * A value within the band updates the value but is not reported as a
+   * change. The version, timestamp, history and change notifications are
+   * left as they were. A change of the valid flag is always reported.
+   * Shall not be called while the value is set by other threads.
+   * @param absolute Absolute band.
+   * @param relative Relative band, 0.01 = 1% of the reported value.
+   * @param hysteresis Extra band when the change reverses direction.
+   */
+  void Deadband(double absolute, double relative = 0.0,
+                double hysteresis = 0.0);
+  [[nodiscard]] const ParameterDeadband* Deadband() const {
+    return deadband_.get();
+  }
+
+  /** @brief Change counter. Incremented each time the value is set. */
+  [[nodiscard]] uint64_t Version() const {
+    return StateWord().load(std::memory_order_acquire) /
+           ValueSlot::kVersionStep;
+  }
+
+  /**
+   * @brief Change counter of the inputs that define the value.
+   *
+   * Same as Version() for a parameter that is set. A parameter that
+   * calculates its value on read, returns a counter that changes when its
+   * inputs change, so a change is detected without reading the value.
+   */
+  [[nodiscard]] virtual uint64_t InputVersion() const { return Version(); }
+
+  /**
+   * @brief Binds the value to a column store.
+   *
+   * The parameter becomes a view onto its index in the store and the
+   * current value is copied to the store. A null store moves the value
+   * back into the parameter. Shall not be called while the value is
+   * accessed by other threads.
+   * @param store Column store or null.
+   * @param index Parameter index in the store.
+   */
+  void Bind(ParameterStore* store, size_t index);
+  [[nodiscard]] const ParameterStore* Store() const { return store_; }
+  [[nodiscard]] size_t StoreIndex() const { return store_index_; }
+
+  /**
+   * @brief Attaches the change notifier of the owning container.
+   *
+   * Changes are only reported while the notifier has subscribers.
+   * @param notifier Change notifier or null.
+   */
+  void AttachNotifier(ChangeNotifier* notifier) { notifier_ = notifier; }
+
+  /**
+   * @brief Subscribes on changes of this parameter.
+   *
+   * The parameter must belong to a container. The callback is called at
+   * most once per dispatch cycle, no matter how many times the value was
+   * set.
+   * @param callback Function that is called with the changed parameter.
+   * @return Subscription identity or 0 if the parameter has no notifier.
+   */
+  size_t Subscribe(ChangeCallback callback);
+  void Unsubscribe(size_t subscription);
+
+  /**
+   * @brief Returns the value converted to the requested type.
+   *
+   * Numeric reads of a string parameter use a numeric shadow value that is
+   * parsed once when the text is set. The read is then as cheap as for a
+   * numeric parameter.
+   * @tparam T Requested type.
+   * @param value Converted value.
+   * @return True if the value is valid.
+   */
   template <typename T>
   [[nodiscard]] bool GetValue(T& value);
 
   template <typename T>
   void SetValue(bool valid, const T& value);
 
+  /**
+   * @brief Parses a number without allocating memory.
+   *
+   * Leading white space and a plus sign are skipped, the same as the stream
+   * operators do. Parsing stops at the first invalid character.
+   * @tparam T Arithmetic type.
+   * @param text Text to parse.
+   * @param value Parsed value. Unchanged if the text is not a number.
+   * @return True if a number was found.
+   */
+  template <typename T>
+  static bool ParseNumber(std::string_view text, T& value);
+
+  /** @brief Buffer that is large enough for any formatted number. */
+  using NumberBuffer = std::array<char, 32>;
+
+  /**
+   * @brief Formats a number without allocating memory.
+   *
+   * Floating point values are formatted with the shortest text that reads
+   * back to the same value.
+   * @tparam T Arithmetic type.
+   * @param value Value to format.
+   * @param buffer Output buffer.
+   * @return View of the formatted text in the buffer.
+   */
+  template <typename T>
+  static std::string_view FormatNumber(T value, NumberBuffer& buffer);
+
   virtual void Init();
   virtual void Tick();
   virtual void Exit();
@@ -97,55 +327,139 @@ class Parameter {
  protected:
   virtual void OnSetValue();
   virtual void OnGetValue();
+
+  /**
+   * @brief Stores a calculated value.
+   *
+   * Used by parameters that calculate their value when it is read. The
+   * version is updated but the value isn't time stamped, added to the
+   * history or reported as a change, so a read doesn't generate change
+   * events. A byte array only stores the valid flag.
+   * @param valid True if the value is valid.
+   * @param value Calculated value.
+   */
+  void CacheValue(bool valid, double value);
  private:
+  friend class ChangeNotifier;
+  template <typename T>
+  friend class TypedParameter;
+
+  inline static const std::string kEmptyText;
+  inline static const EnumList kEmptyEnumList;
+
   std::string name_; ///< Name used internally
-  std::string unit_; ///< Unit of measure
-  std::string description_; ///< Optional description of the parameter
   std::string device_; ///< Test equipment reference
-  std::string signal_; ///< Signal or channel name
-  std::string identity_; ///< Free of use but normally external ID
-  std::string display_name_; ///< Display name used as label
-
   ParameterDataType data_type_ = ParameterDataType::FloatType;
-  EnumList enum_list_;
-
-  // Thread safe handling of valid and value objects
-  mutable std::mutex value_lock_;
-  bool valid_ = false;
-  double value_float_ = 0.0;
-  int64_t value_int_ = 0;
-  uint64_t value_uint_ = 0;
-  std::string value_text_;
-  ByteArray value_array_;
-
+  std::atomic<bool> pending_ = false; ///< Change is queued for dispatch
+  uint32_t store_index_ = 0; ///< Index in the column store
+  ParameterStore* store_ = nullptr; ///< Column store if bound
+  ChangeNotifier* notifier_ = nullptr; ///< Change notifier if any
+  mutable ValueSlot slot_; ///< Lock-free value if not bound to a store
+  /// Text and byte array value. Only allocated for those data types.
+  std::unique_ptr<std::atomic<SharedBuffer>> buffer_;
+  std::unique_ptr<ParameterInfo> info_; ///< Descriptive properties
+  std::unique_ptr<ParameterHistory> history_; ///< Latest values if any
+  std::unique_ptr<ParameterDeadband> deadband_; ///< Change filter if any
+
+  [[nodiscard]] ParameterInfo& Info();
+  [[nodiscard]] std::atomic<uint64_t>& StateWord() const {
+    return store_ != nullptr ? store_->State(store_index_) : slot_.state;
+  }
+  [[nodiscard]] std::atomic<uint64_t>& ValueWord() const {
+    return store_ != nullptr ? store_->Value(store_index_) : slot_.value;
+  }
+  [[nodiscard]] const std::string* EnumName(uint64_t bits) const {
+    const auto* enum_table = GetEnumTable();
+    return enum_table != nullptr ?
+        enum_table->Name(std::bit_cast<int64_t>(bits)) : nullptr;
+  }
+  [[nodiscard]] bool LoadValue(uint64_t& value) const;
+  [[nodiscard]] bool LoadBuffer(SharedBuffer& buffer) const;
+  void StoreValue(bool valid, uint64_t value);
+  void StoreBuffer(bool valid, ByteArray&& buffer);
+  void StoreBuffer(bool valid, SharedBuffer buffer, bool report = true);
+  [[nodiscard]] double ValueAsDouble(uint64_t bits) const;
+  [[nodiscard]] bool InDeadband(uint64_t state, bool valid, uint64_t value);
+  [[nodiscard]] uint64_t BeginWrite();
+  void EndWrite(uint64_t state, bool valid, bool report = true);
 };
 
+// Inline as it is the hot path of all numeric reads
+inline bool Parameter::LoadValue(uint64_t& value) const {
+  const auto& state_word = StateWord();
+  const auto& value_word = ValueWord();
+  while (true) {
+    const uint64_t state = state_word.load(std::memory_order_acquire);
+    if ((state & ValueSlot::kWriteBit) == 0) {
+      value = value_word.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (state_word.load(std::memory_order_relaxed) == state) {
+        return (state & ValueSlot::kValidBit) != 0;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
 template <typename T>
 bool Parameter::GetValue(T& value) {
   OnGetValue();
-  std::scoped_lock lock(value_lock_);
+  uint64_t bits = 0;
   switch (data_type_) {
     case ParameterDataType::UnsignedType:
-    case ParameterDataType::BooleanType:
-      value = static_cast<T>(value_uint_);
-      break;
+    case ParameterDataType::BooleanType: {
+      const bool valid = LoadValue(bits);
+      value = static_cast<T>(bits);
+      return valid;
+    }
 
     case ParameterDataType::EnumType:
-    case ParameterDataType::SignedType:
-      value = static_cast<T>(value_int_);
-      break;
+    case ParameterDataType::SignedType: {
+      const bool valid = LoadValue(bits);
+      value = static_cast<T>(std::bit_cast<int64_t>(bits));
+      return valid;
+    }
 
-    case ParameterDataType::FloatType:
-      value = static_cast<T>(value_float_);
-      break;
+    case ParameterDataType::FloatType: {
+      const bool valid = LoadValue(bits);
+      value = static_cast<T>(std::bit_cast<double>(bits));
+      return valid;
+    }
 
     case ParameterDataType::StringType: {
-      try {
-        std::istringstream input(value_text_);
-        input >> value;
-      } catch( const std::exception& ) {
+      if constexpr (std::is_arithmetic_v<T>) {
+        // The value word holds the parsed text as a double
+        const bool valid = LoadValue(bits);
+        const double shadow = std::bit_cast<double>(bits);
+        if constexpr (std::is_integral_v<T>) {
+          // Large integers are not exact as a double. NaN fails the test.
+          constexpr double kMaxExact = 9007199254740992.0; // 2^53
+          if (!(std::abs(shadow) < kMaxExact)) {
+            SharedBuffer text;
+            value = 0;
+            if (LoadBuffer(text) && text) {
+              ParseNumber(std::string_view(
+                  reinterpret_cast<const char*>(text->data()), text->size()),
+                  value);
+            }
+            return valid;
+          }
+        }
+        value = static_cast<T>(shadow);
+        return valid;
+      } else {
+        SharedBuffer text;
+        const bool valid = LoadBuffer(text);
+        try {
+          if (text) {
+            std::istringstream input(std::string(text->cbegin(),
+                                                 text->cend()));
+            input >> value;
+          }
+        } catch( const std::exception& ) {
+        }
+        return valid;
       }
-      break;
     }
 
     case ParameterDataType::ByteArrayType:
@@ -153,7 +467,7 @@ bool Parameter::GetValue(T& value) {
       break;
   }
 
-  return valid_;
+  return Valid();
 }
 
 template <>
@@ -165,35 +479,43 @@ bool Parameter::GetValue(std::string& value);
 template <>
 bool Parameter::GetValue(ByteArray& value);
 
+/**
+ * @brief Returns a shared view of a text or byte array value.
+ *
+ * The buffer is not copied. The buffer is immutable and stays valid as
+ * long as the caller holds it, also if the parameter is set again.
+ */
+template <>
+bool Parameter::GetValue(SharedBuffer& value);
+
 template <typename T>
 void Parameter::SetValue(bool valid, const T& value) {
-  {
-    std::scoped_lock lock(value_lock_);
-    valid_ = valid;
-
-    switch (data_type_) {
-      case ParameterDataType::BooleanType:
-      case ParameterDataType::UnsignedType:value_uint_ = static_cast<uint64_t>(value);
-        break;
-
-      case ParameterDataType::EnumType:
-      case ParameterDataType::SignedType:value_int_ = static_cast<int64_t>(value);
-        break;
+  switch (data_type_) {
+    case ParameterDataType::BooleanType:
+    case ParameterDataType::UnsignedType:
+      StoreValue(valid, static_cast<uint64_t>(value));
+      break;
 
-      case ParameterDataType::FloatType:value_float_ = static_cast<double>(value);
-        break;
+    case ParameterDataType::EnumType:
+    case ParameterDataType::SignedType:
+      StoreValue(valid, std::bit_cast<uint64_t>(static_cast<int64_t>(value)));
+      break;
 
-      case ParameterDataType::StringType: {
-        try {
-          value_text_ = std::to_string(value);
-        } catch (const std::exception &) {
-        }
-        break;
-      }
+    case ParameterDataType::FloatType:
+      StoreValue(valid, std::bit_cast<uint64_t>(static_cast<double>(value)));
+      break;
 
-      case ParameterDataType::ByteArrayType:
-      default:break;
+    case ParameterDataType::StringType: {
+      NumberBuffer buffer;
+      const auto text = FormatNumber(value, buffer);
+      StoreBuffer(valid, ByteArray(text.cbegin(), text.cend()));
+      break;
     }
+
+    case ParameterDataType::ByteArrayType:
+    default:
+      Valid(valid);
+      break;
   }
   OnSetValue();
 }
@@ -201,11 +523,51 @@ void Parameter::SetValue(bool valid, const T& value) {
 template <>
 void Parameter::SetValue(bool valid, const bool& value);
 
+template <typename T>
+bool Parameter::ParseNumber(std::string_view text, T& value) {
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.front()))) {
+    text.remove_prefix(1);
+  }
+  if (!text.empty() && text.front() == '+') {
+    text.remove_prefix(1);
+  }
+  const auto [last, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc();
+}
+
+template <typename T>
+std::string_view Parameter::FormatNumber(T value, NumberBuffer& buffer) {
+  const auto [last, error] =
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+  return error == std::errc() ? std::string_view(buffer.data(),
+                                                 last - buffer.data())
+                              : std::string_view();
+}
+
 template <>
 void Parameter::SetValue(bool valid, const std::string& value);
 
 template <>
 void Parameter::SetValue(bool valid, const ByteArray& value);
 
+/**
+ * @brief Sets a text or byte array value without copying it.
+ *
+ * The parameter shares the buffer, so the buffer shall not be changed
+ * after this call.
+ */
+template <>
+void Parameter::SetValue(bool valid, const SharedBuffer& value);
+
+/**
+ * @brief Sets a value from a byte range.
+ *
+ * The bytes are copied once into a buffer from the default buffer pool.
+ */
+template <>
+void Parameter::SetValue(bool valid, const ByteSpan& value);
+
 
 }  // namespace workflow
@@ -10,6 +10,11 @@
 #include <vector>
 #include <utility>
 #include "workflow/parameter.h"
+#include "workflow/derivedparameter.h"
+#include "workflow/typedparameter.h"
+#include "workflow/parameterstore.h"
+#include "workflow/sharedparameterstore.h"
+#include "workflow/changenotifier.h"
 #include "workflow/device.h"
 namespace util::xml {
 
@@ -34,6 +39,70 @@ class ParameterContainer {
   void IgnoreCase(bool ignore) {ignore_case_name_ = ignore; }
   [[nodiscard]] bool IgnoreCase() const {return ignore_case_name_;}
 
+  /**
+   * @brief Stores the parameter values in a column store.
+   *
+   * If set, the Init() function creates a column store and binds all
+   * parameters to it. The values can then be scanned without visiting
+   * each parameter object. Parameters created after Init() are bound by
+   * the next Init() call.
+   * @param column_store True if the values shall be in a column store.
+   */
+  void ColumnStore(bool column_store) {column_store_ = column_store;}
+  [[nodiscard]] bool ColumnStore() const {return column_store_;}
+
+  /**
+   * @brief Places the column store in a named shared memory segment.
+   *
+   * If set, the Init() function creates the column store in the segment
+   * and publishes the parameter names and data types. Other processes can
+   * then read the values with a SharedParameterStore. The store is a
+   * private column store if the segment can't be created.
+   * @param name Segment name. Empty name means no shared memory.
+   */
+  void SharedMemory(const std::string& name) {shared_memory_ = name;}
+  [[nodiscard]] const std::string& SharedMemory() const {
+    return shared_memory_;
+  }
+  [[nodiscard]] const SharedParameterStore* GetSharedStore() const {
+    return shared_store_.get();
+  }
+
+  [[nodiscard]] const ParameterStore* GetStore() const {return store_.get();}
+  [[nodiscard]] ParameterStore* GetStore() {return store_.get();}
+
+  /**
+   * @brief Takes a consistent snapshot of the parameter values.
+   *
+   * Requires the column store. The snapshot is a copy of the values at one
+   * point in time and the writers are not blocked while it is taken.
+   * @param snapshot Destination of the copy.
+   * @param device Only copy the parameters of this device if not empty.
+   * @return False if there is no column store.
+   */
+  bool Snapshot(StoreSnapshot& snapshot,
+                const std::string& device = {}) const;
+
+  /**
+   * @brief Subscribes on parameter changes.
+   *
+   * The changes are dispatched by the Tick() function. Each subscriber
+   * gets at most one notification per tick.
+   * @param callback Function that is called with the changed parameters.
+   * @param filter Parameters to subscribe on. Empty list means all.
+   * @return Subscription identity.
+   */
+  size_t Subscribe(ChangeCallback callback, const ChangeList& filter = {}) {
+    return notifier_.Subscribe(std::move(callback), filter);
+  }
+  size_t Subscribe(WorkflowQueue& queue, const ChangeList& filter = {}) {
+    return notifier_.Subscribe(queue, filter);
+  }
+  void Unsubscribe(size_t subscription) {
+    notifier_.Unsubscribe(subscription);
+  }
+  [[nodiscard]] ChangeNotifier& Notifier() {return notifier_;}
+
   [[nodiscard]] const DeviceList& Devices() const {
     return device_list_;
   }
@@ -50,8 +119,44 @@ class ParameterContainer {
 
   virtual Parameter* CreateParameter(const std::string& device_name,
                              const std::string& parameter_name);
+  /**
+   * @brief Creates a parameter that is calculated from other parameters.
+   *
+   * The formula is compiled by Init(), so the parameters in the formula
+   * may be created after this call.
+   * @param device_name Device name.
+   * @param parameter_name Parameter name.
+   * @param expression Formula, for example "(Speed * 3.6) + Offset".
+   * @return The new parameter or null if the name is in use.
+   */
+  DerivedParameter* CreateDerivedParameter(const std::string& device_name,
+                                           const std::string& parameter_name,
+                                           const std::string& expression);
   [[nodiscard]] Parameter* GetParameter(const std::string& device,
                                         const std::string& name) const;
+  /**
+   * @brief Returns a typed handle to a parameter.
+   *
+   * The handle is unbound, IsOk() is false, if the parameter doesn't exist
+   * or if its data type doesn't match the type.
+   * @tparam T Numeric or boolean type.
+   * @param device Device name.
+   * @param name Parameter name.
+   * @return Typed handle.
+   */
+  template <typename T>
+  [[nodiscard]] TypedParameter<T> GetTypedParameter(
+      const std::string& device, const std::string& name) const {
+    return TypedParameter<T>(GetParameter(device, name));
+  }
+  /**
+   * @brief Deletes a parameter.
+   *
+   * Derived parameters that use the parameter are compiled again. Their
+   * value is invalid if the formula no longer compiles.
+   * @param device_name Device name.
+   * @param parameter_name Parameter name.
+   */
   void DeleteParameter(const std::string& device_name,
                        const std::string& parameter_name);
 
@@ -67,9 +172,18 @@ class ParameterContainer {
   virtual void ReadXml(const util::xml::IXmlNode& root);
 
  private:
+  /// The segment shall be destroyed after the store.
+  std::unique_ptr<SharedParameterStore> shared_store_;
+  /// The store and notifier shall be destroyed after the parameters.
+  std::unique_ptr<ParameterStore> store_;
+  ChangeNotifier notifier_;
   DeviceList device_list_;
   ParameterList parameter_list_;
 
   bool ignore_case_name_ = false;
+  bool column_store_ = false;
+  std::string shared_memory_; ///< Shared memory segment name
+
+  void BuildStore();
 };
 }  // namespace workflow
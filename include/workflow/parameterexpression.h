@@ -0,0 +1,108 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace workflow {
+
+class Parameter;
+
+/**
+ * @class ParameterExpression
+ *
+ * @brief Arithmetic expression over parameter values.
+ *
+ * The expression is compiled once into a list of stack machine
+ * instructions, so an evaluation doesn't parse any text or allocate any
+ * memory. The syntax is:
+ * - Numbers: 1, 2.5, 1e-3.
+ * - Operators: + - * / ^ and parentheses. Unary minus.
+ * - Functions: abs(x), sqrt(x), min(x,y) and max(x,y).
+ * - Parameters: Name, Device.Name or {Any name} for names with spaces and
+ *   operator characters.
+ *
+ * The parameter names are resolved by a function that the owner supplies.
+ */
+class ParameterExpression {
+ public:
+  /** @brief Returns the parameter with a name or null if not found. */
+  using Resolver = std::function<Parameter*(const std::string& name)>;
+
+  /**
+   * @brief Compiles an expression.
+   * @param text Expression text.
+   * @param resolver Finds the parameters in the expression.
+   * @return True if the expression is valid.
+   */
+  bool Compile(const std::string& text, const Resolver& resolver);
+  void Clear();
+
+  [[nodiscard]] bool IsOk() const { return !program_.empty(); }
+  [[nodiscard]] const std::string& LastError() const { return last_error_; }
+
+  /** @brief Parameters that the expression depends on. No duplicates. */
+  [[nodiscard]] const std::vector<Parameter*>& Dependencies() const {
+    return dependency_list_;
+  }
+  [[nodiscard]] size_t NofInstructions() const { return program_.size(); }
+
+  /**
+   * @brief Evaluates the expression.
+   * @param value Result.
+   * @return True if all parameters in the expression are valid.
+   */
+  [[nodiscard]] bool Evaluate(double& value) const;
+
+ private:
+  enum class OpCode : uint8_t {
+    Constant,
+    Load,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Power,
+    Negate,
+    Abs,
+    Sqrt,
+    Min,
+    Max,
+  };
+
+  struct Instruction {
+    OpCode op_code = OpCode::Constant;
+    double constant = 0.0;
+    Parameter* parameter = nullptr;
+  };
+
+  std::vector<Instruction> program_;
+  std::vector<Parameter*> dependency_list_;
+  std::string last_error_;
+
+  // Parser state. Only used while compiling.
+  std::string_view text_;
+  size_t pos_ = 0;
+  size_t depth_ = 0; ///< Stack depth of the program so far
+  size_t max_depth_ = 0;
+  const Resolver* resolver_ = nullptr;
+
+  void SkipSpace();
+  bool Error(const std::string& error);
+  void Emit(OpCode op_code, double constant = 0.0,
+            Parameter* parameter = nullptr);
+  bool ParseExpression();
+  bool ParseTerm();
+  bool ParseUnary();
+  bool ParsePower();
+  bool ParsePrimary();
+  bool ParseReference(const std::string& name, size_t start);
+};
+
+}  // namespace workflow
@@ -0,0 +1,100 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace workflow {
+
+/** @brief One historical value of a parameter. */
+struct HistorySample {
+  uint64_t timestamp = 0; ///< Monotonic time in ns
+  double value = 0.0; ///< Value as a double
+  bool valid = false; ///< Valid flag of the value
+};
+
+using HistoryList = std::vector<HistorySample>;
+
+/** @brief Aggregates of the valid samples in a time range. */
+struct HistoryStatistics {
+  size_t count = 0; ///< Number of valid samples
+  double min = 0.0; ///< Minimum value
+  double max = 0.0; ///< Maximum value
+  double average = 0.0; ///< Average value
+  double rate = 0.0; ///< Change per second between first and last sample
+};
+
+/**
+ * @class ParameterHistory
+ *
+ * @brief Fixed size ring buffer with the latest values of a parameter.
+ *
+ * The parameter adds a sample each time its value is set. There is only
+ * one writer at a time, as the parameter serializes its writers. Readers
+ * never block the writer. A reader skips samples that are overwritten
+ * while they are copied.
+ */
+class ParameterHistory {
+ public:
+  explicit ParameterHistory(size_t capacity);
+  virtual ~ParameterHistory() = default;
+
+  ParameterHistory(const ParameterHistory& history) = delete;
+  ParameterHistory& operator = (const ParameterHistory& history) = delete;
+
+  [[nodiscard]] size_t Capacity() const { return capacity_; }
+  /** @brief Number of samples in the buffer. */
+  [[nodiscard]] size_t Size() const;
+  /** @brief Total number of samples added. */
+  [[nodiscard]] uint64_t NofSamples() const {
+    return head_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Adds a sample. Overwrites the oldest sample if full.
+   *
+   * Shall only be called by one thread at a time.
+   */
+  void Add(uint64_t timestamp, bool valid, double value);
+
+  /**
+   * @brief Copies the samples within a time range.
+   *
+   * The samples are sorted by time, oldest first.
+   * @param from Start time in ns (inclusive).
+   * @param to End time in ns (inclusive).
+   * @param sample_list Destination list.
+   */
+  void Range(uint64_t from, uint64_t to, HistoryList& sample_list) const;
+
+  /**
+   * @brief Calculates min, max, average and rate within a time range.
+   *
+   * Only valid samples are used.
+   * @param from Start time in ns (inclusive).
+   * @param to End time in ns (inclusive).
+   * @param statistics Result.
+   * @return True if there was any valid sample in the range.
+   */
+  bool Statistics(uint64_t from, uint64_t to,
+                  HistoryStatistics& statistics) const;
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> sequence = 0; ///< Sample number + 1, 0 = writing
+    std::atomic<uint64_t> timestamp = 0;
+    std::atomic<uint64_t> value = 0; ///< Double bit pattern
+    std::atomic<bool> valid = false;
+  };
+
+  size_t capacity_ = 0;
+  std::unique_ptr<Entry[]> entry_list_;
+  std::atomic<uint64_t> head_ = 0; ///< Number of added samples
+};
+
+}  // namespace workflow
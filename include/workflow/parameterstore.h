@@ -0,0 +1,208 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace workflow {
+
+/**
+ * @brief Value storage of a parameter.
+ *
+ * The slot holds the value of numeric and boolean parameters and the time
+ * of the last write. The state word is a sequence lock that also holds the
+ * valid flag and the change counter. Text and byte array values are stored
+ * out of line.
+ */
+struct ValueSlot {
+  static constexpr uint64_t kValidBit = 0x01;
+  static constexpr uint64_t kWriteBit = 0x02; ///< Write in progress
+  static constexpr uint64_t kVersionStep = 0x04;
+
+  std::atomic<uint64_t> state = 0; ///< Version, write and valid bits
+  std::atomic<uint64_t> value = 0; ///< Float, signed or unsigned value
+  std::atomic<uint64_t> timestamp = 0; ///< Monotonic time in ns
+};
+
+/**
+ * @brief Copy of the value columns in a parameter store.
+ *
+ * The lists are indexed by the parameter index in the store, or by the
+ * position in the index list if only a subset was copied.
+ */
+struct StoreSnapshot {
+  std::vector<size_t> index_list; ///< Store indexes if a subset
+  std::vector<uint64_t> state_list; ///< Version, write and valid bits
+  std::vector<uint64_t> value_list; ///< 64-bit value pattern
+  std::vector<uint64_t> timestamp_list; ///< Monotonic time in ns
+  std::vector<uint64_t> sequence_list; ///< Store sequence of last change
+  uint64_t sequence = 0; ///< Store sequence when the snapshot was taken
+  size_t nof_retries = 0; ///< Number of copies discarded due to writes
+};
+
+/**
+ * @class ParameterStore
+ *
+ * @brief Columnar value storage for the parameters in a container.
+ *
+ * The store holds the values as a struct of arrays. Each column is a
+ * contiguous array indexed by the parameter index, so scanning all values
+ * doesn't chase any pointers. Parameters that are bound to the store are
+ * views onto their index in the columns.
+ *
+ * The state column is the same sequence lock word as in the parameter
+ * value slot, so the valid flag is bit 0 of the state. Each write also
+ * stores a monotonic timestamp and a store wide change sequence number.
+ *
+ * Snapshots are consistent over the whole store. A snapshot is copied
+ * again if any value was written during the copy, so writers are never
+ * blocked by readers. Writers that update a group of related values use
+ * BeginGroup() and EndGroup(), so a snapshot never sees half a group.
+ *
+ * The size of the store is fixed when it is created. The columns are
+ * either owned by the store or placed in an external memory block, for
+ * example a shared memory segment. The block layout is the store sequence,
+ * the epoch and then the state, value, timestamp and sequence columns, all
+ * as 64-bit words.
+ *
+ * A reader in another process cannot rely on the writer to clear the write
+ * bit or to end a group, as the writer may die in the middle of a write.
+ * Such a reader shall limit the number of read retries, see MaxRetries().
+ */
+class ParameterStore {
+ public:
+  explicit ParameterStore(size_t size);
+  /**
+   * @brief Creates a store in an external memory block.
+   *
+   * The block shall be BlockSize() bytes, 8-byte aligned and zero filled
+   * when the store is new. The block shall outlive the store. A store on
+   * read-only memory may only be read.
+   * @param size Number of parameters.
+   * @param block Start of the memory block.
+   */
+  ParameterStore(size_t size, void* block);
+  virtual ~ParameterStore() = default;
+
+  ParameterStore(const ParameterStore& store) = delete;
+  ParameterStore& operator = (const ParameterStore& store) = delete;
+
+  [[nodiscard]] size_t Size() const { return size_; }
+
+  /** @brief Returns the number of bytes needed for a block of a size. */
+  [[nodiscard]] static size_t BlockSize(size_t size) {
+    return (2 + 4 * size) * sizeof(uint64_t);
+  }
+
+  [[nodiscard]] std::atomic<uint64_t>& State(size_t index) const {
+    return state_list_[index];
+  }
+  [[nodiscard]] std::atomic<uint64_t>& Value(size_t index) const {
+    return value_list_[index];
+  }
+  [[nodiscard]] uint64_t Timestamp(size_t index) const {
+    return timestamp_list_[index].load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] uint64_t Sequence(size_t index) const {
+    return sequence_list_[index].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Limits the number of retries of a read or a snapshot.
+   *
+   * The read gives up when a value has been written during more than this
+   * number of read attempts. The default 0 means no limit, which is fine
+   * when the writers are in the same process.
+   * @param max_retries Maximum number of retries or 0 for no limit.
+   */
+  void MaxRetries(size_t max_retries) {max_retries_ = max_retries;}
+  [[nodiscard]] size_t MaxRetries() const {return max_retries_;}
+
+  /** @brief Last change sequence number in the store. */
+  [[nodiscard]] uint64_t LastSequence() const {
+    return sequence_->load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Reads a value without locking.
+   *
+   * Same sequence lock read as the parameter does on its own slot.
+   * @param index Parameter index.
+   * @param value 64-bit value pattern.
+   * @return True if the value is valid. False if it is invalid or if the
+   * read gave up, see MaxRetries().
+   */
+  [[nodiscard]] bool Load(size_t index, uint64_t& value) const;
+
+  /**
+   * @brief Stamps a parameter write.
+   *
+   * Called by the parameter while it holds the write bit.
+   * @param index Parameter index.
+   * @param timestamp Monotonic time of the write in ns.
+   */
+  void Stamp(size_t index, uint64_t timestamp);
+
+  /**
+   * @brief Starts a group write.
+   *
+   * Snapshots wait until the group is done. Group writers are serialized.
+   * Each BeginGroup() call shall be followed by an EndGroup() call.
+   */
+  void BeginGroup();
+  void EndGroup();
+
+  /**
+   * @brief Copies all columns.
+   *
+   * The copy is a consistent view of the store at one point in time.
+   * @param snapshot Destination of the copy.
+   * @return False if the copy gave up, see MaxRetries().
+   */
+  bool Snapshot(StoreSnapshot& snapshot) const;
+
+  /**
+   * @brief Copies a subset of the columns.
+   * @param snapshot Destination of the copy.
+   * @param index_list Store indexes to copy.
+   * @return False if the copy gave up, see MaxRetries().
+   */
+  bool Snapshot(StoreSnapshot& snapshot,
+                const std::vector<size_t>& index_list) const;
+
+  /**
+   * @brief Returns the parameters that changed after a sequence number.
+   * @param sequence Sequence number from LastSequence() or a snapshot.
+   * @param index_list Indexes of the changed parameters.
+   */
+  void ChangedSince(uint64_t sequence, std::vector<size_t>& index_list) const;
+
+ private:
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "The columns may be placed in shared memory");
+
+  size_t size_ = 0;
+  size_t max_retries_ = 0; ///< 0 = retry until the read is consistent
+  std::unique_ptr<std::atomic<uint64_t>[]> block_; ///< Owned block or null
+  std::atomic<uint64_t>* sequence_ = nullptr; ///< Store change sequence
+  std::atomic<uint64_t>* epoch_ = nullptr; ///< Odd while a group is written
+  std::atomic<uint64_t>* state_list_ = nullptr;
+  std::atomic<uint64_t>* value_list_ = nullptr;
+  std::atomic<uint64_t>* timestamp_list_ = nullptr;
+  std::atomic<uint64_t>* sequence_list_ = nullptr;
+  std::mutex group_lock_; ///< Serializes group writers in this process
+
+  void AssignColumns(std::atomic<uint64_t>* block);
+
+  [[nodiscard]] bool CopyEntry(size_t index, size_t pos,
+                               StoreSnapshot& snapshot) const;
+  bool CopyEntries(StoreSnapshot& snapshot, bool subset) const;
+};
+
+}  // namespace workflow
@@ -0,0 +1,103 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "workflow/parameter.h"
+
+namespace workflow {
+
+class ParameterContainer;
+
+/** @brief Staged value in a parameter transaction. */
+using StagedValue = std::variant<bool, int64_t, uint64_t, double, std::string,
+                                 ByteArray>;
+
+/**
+ * @class ParameterTransaction
+ *
+ * @brief Writes a group of parameter values as one change.
+ *
+ * The values are staged with SetValue() and nothing is written until
+ * Commit() is called. The commit writes all values as one group in the
+ * column store, so a snapshot sees either all or none of the values. The
+ * changes are queued to the notifier in one step, so each subscriber gets
+ * all of them in one notification.
+ *
+ * Typical use is a task that updates many parameters from one acquisition
+ * frame.
+ */
+class ParameterTransaction {
+ public:
+  explicit ParameterTransaction(ParameterContainer& container);
+  virtual ~ParameterTransaction() = default;
+
+  ParameterTransaction(const ParameterTransaction& transaction) = delete;
+  ParameterTransaction& operator = (const ParameterTransaction& transaction)
+      = delete;
+
+  template <typename T>
+  void SetValue(Parameter& parameter, bool valid, const T& value);
+
+  [[nodiscard]] size_t Size() const { return item_list_.size(); }
+  [[nodiscard]] bool Empty() const { return item_list_.empty(); }
+  void Clear() { item_list_.clear(); }
+
+  /**
+   * @brief Writes all staged values.
+   *
+   * The staged values are cleared after the commit.
+   * @return Commit latency in nanoseconds.
+   */
+  uint64_t Commit();
+
+  /** @brief Latency of the last commit in nanoseconds. */
+  [[nodiscard]] uint64_t LastLatency() const { return last_latency_; }
+  /** @brief Maximum commit latency in nanoseconds. */
+  [[nodiscard]] uint64_t MaxLatency() const { return max_latency_; }
+  [[nodiscard]] uint64_t NofCommits() const { return nof_commits_; }
+
+ private:
+  struct Item {
+    Parameter* parameter = nullptr;
+    bool valid = false;
+    StagedValue value;
+  };
+
+  ParameterContainer& container_;
+  std::vector<Item> item_list_;
+  uint64_t last_latency_ = 0;
+  uint64_t max_latency_ = 0;
+  uint64_t nof_commits_ = 0;
+};
+
+template <typename T>
+void ParameterTransaction::SetValue(Parameter& parameter, bool valid,
+                                    const T& value) {
+  Item item;
+  item.parameter = &parameter;
+  item.valid = valid;
+  if constexpr (std::is_same_v<T, bool>) {
+    item.value = value;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    item.value = static_cast<double>(value);
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    item.value = static_cast<int64_t>(value);
+  } else if constexpr (std::is_integral_v<T>) {
+    item.value = static_cast<uint64_t>(value);
+  } else if constexpr (std::is_same_v<T, ByteArray>) {
+    item.value = value;
+  } else {
+    item.value = std::string(value);
+  }
+  item_list_.push_back(std::move(item));
+}
+
+}  // namespace workflow
@@ -0,0 +1,130 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "workflow/parameter.h"
+#include "workflow/parameterstore.h"
+
+namespace boost::interprocess {
+
+class mapped_region;
+
+}  // namespace boost::interprocess
+
+namespace workflow {
+
+/**
+ * @brief Published description of a parameter in a shared store.
+ */
+struct SharedSchemaEntry {
+  size_t index = 0; ///< Index in the store columns
+  std::string device; ///< Device name
+  std::string name; ///< Parameter name
+  std::string unit; ///< Unit of the value
+  ParameterDataType data_type = ParameterDataType::FloatType;
+};
+
+/**
+ * @class SharedParameterStore
+ *
+ * @brief Parameter store in a named shared memory segment.
+ *
+ * The owner process creates the segment from its parameter list and binds
+ * its parameters to the returned store. Other processes on the same
+ * computer open the segment by name and read the values directly from the
+ * mapped memory. A read is the same sequence lock read as in the owner, so
+ * it doesn't do any system call or copy and it never blocks the writer.
+ *
+ * The segment starts with a fixed header, followed by the store block, see
+ * ParameterStore, and the schema. The schema is a text table with one line
+ * per parameter: index, device, name, unit and data type, separated by
+ * tabs. Readers map the segment read-only.
+ *
+ * Text and byte array values are not in the segment, only the numeric
+ * shadow of text values. The owner removes the segment when it is closed.
+ * A reader that still has the segment open sees that it is off-line and
+ * should open it again. The reads in the reader view give up after a
+ * limited number of retries, so a reader isn't stuck if the owner dies in
+ * the middle of a write.
+ */
+class SharedParameterStore {
+ public:
+  SharedParameterStore();
+  virtual ~SharedParameterStore();
+
+  SharedParameterStore(const SharedParameterStore& store) = delete;
+  SharedParameterStore& operator = (const SharedParameterStore& store) = delete;
+
+  /**
+   * @brief Creates the segment and publishes the schema.
+   *
+   * The create fails if another process that is still running owns a
+   * segment with the same name. A segment that is left by an owner that
+   * died, is replaced.
+   * The returned store shall be deleted before this object is closed.
+   * @param name Segment name.
+   * @param parameter_list Parameters in store index order. Null entries
+   * are allowed.
+   * @return Store in the segment or null on failure.
+   */
+  [[nodiscard]] std::unique_ptr<ParameterStore> Create(
+      const std::string& name,
+      const std::vector<std::unique_ptr<Parameter>>& parameter_list);
+
+  /**
+   * @brief Opens a segment that another process has created.
+   * @param name Segment name.
+   * @return True if the segment is valid.
+   */
+  bool Open(const std::string& name);
+
+  /** @brief Unmaps the segment. The owner also removes the segment. */
+  void Close();
+
+  [[nodiscard]] const std::string& Name() const {return name_;}
+  [[nodiscard]] bool IsOwner() const {return owner_;}
+  [[nodiscard]] bool IsOk() const {return static_cast<bool>(region_);}
+  [[nodiscard]] const std::string& LastError() const {return last_error_;}
+
+  /** @brief Returns true while the owner has the segment open. */
+  [[nodiscard]] bool Online() const;
+
+  /** @brief Reader view of the store. Null in the owner. */
+  [[nodiscard]] const ParameterStore* GetStore() const {return store_.get();}
+
+  [[nodiscard]] const std::vector<SharedSchemaEntry>& Schema() const {
+    return schema_;
+  }
+  [[nodiscard]] const SharedSchemaEntry* Find(const std::string& device,
+                                              const std::string& name) const;
+
+  /**
+   * @brief Reads a value as a double.
+   * @param entry Schema entry of the parameter.
+   * @param value Destination of the value.
+   * @return True if the value is valid. False if it is invalid, the owner
+   * is off-line or the value couldn't be read.
+   */
+  bool GetValue(const SharedSchemaEntry& entry, double& value) const;
+
+  /** @brief Removes a segment by name. */
+  static bool Remove(const std::string& name);
+
+ private:
+  std::string name_;
+  bool owner_ = false;
+  std::unique_ptr<boost::interprocess::mapped_region> region_;
+  std::unique_ptr<ParameterStore> store_; ///< Reader view
+  std::vector<SharedSchemaEntry> schema_;
+  std::string last_error_;
+
+  bool ParseSchema(std::string_view schema, size_t nof_parameters);
+};
+
+}  // namespace workflow
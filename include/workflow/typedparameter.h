@@ -0,0 +1,145 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+#include "workflow/parameter.h"
+
+namespace workflow {
+
+/**
+ * @class TypedParameter
+ *
+ * @brief Handle to a numeric or boolean parameter with a fixed type.
+ *
+ * The handle checks once that the parameter data type matches the C++
+ * type, when it is bound. Get and set then go straight to the lock-free
+ * value without a data type switch. The virtual OnGetValue() and
+ * OnSetValue() hooks are only called if the parameter is a sub-class of
+ * Parameter, as for example a derived parameter.
+ *
+ * The type mapping is:
+ * - bool: BooleanType.
+ * - Signed integers: SignedType and EnumType.
+ * - Unsigned integers: UnsignedType.
+ * - Floating point: FloatType.
+ * @tparam T Arithmetic type.
+ */
+template <typename T>
+class TypedParameter {
+  static_assert(std::is_arithmetic_v<T>,
+                "Only numeric and boolean types are supported");
+ public:
+  TypedParameter() = default;
+  /**
+   * @brief Binds the handle to a parameter.
+   *
+   * The handle is unbound if the parameter is null or doesn't have a
+   * matching data type.
+   * @param parameter Parameter to bind.
+   */
+  explicit TypedParameter(Parameter* parameter);
+
+  [[nodiscard]] static bool Matches(ParameterDataType type);
+
+  [[nodiscard]] bool IsOk() const { return parameter_ != nullptr; }
+  [[nodiscard]] Parameter* GetParameter() const { return parameter_; }
+
+  /**
+   * @brief Returns the value.
+   * @param value Value.
+   * @return True if the value is valid.
+   */
+  bool Get(T& value) const;
+  [[nodiscard]] T Value() const {
+    T value {};
+    Get(value);
+    return value;
+  }
+
+  void Set(bool valid, T value);
+
+ private:
+  Parameter* parameter_ = nullptr;
+  bool plain_ = false; ///< True if no virtual hooks needs to be called
+
+  [[nodiscard]] static uint64_t ToBits(T value);
+  [[nodiscard]] static T FromBits(uint64_t bits);
+};
+
+template <typename T>
+TypedParameter<T>::TypedParameter(Parameter* parameter) {
+  if (parameter != nullptr && Matches(parameter->DataType())) {
+    parameter_ = parameter;
+    plain_ = typeid(*parameter) == typeid(Parameter);
+  }
+}
+
+template <typename T>
+bool TypedParameter<T>::Matches(ParameterDataType type) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return type == ParameterDataType::BooleanType;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return type == ParameterDataType::FloatType;
+  } else if constexpr (std::is_signed_v<T>) {
+    return type == ParameterDataType::SignedType ||
+           type == ParameterDataType::EnumType;
+  } else {
+    return type == ParameterDataType::UnsignedType;
+  }
+}
+
+template <typename T>
+bool TypedParameter<T>::Get(T& value) const {
+  if (!plain_) {
+    return parameter_ != nullptr && parameter_->GetValue(value);
+  }
+  uint64_t bits = 0;
+  const bool valid = parameter_->LoadValue(bits);
+  value = FromBits(bits);
+  return valid;
+}
+
+template <typename T>
+void TypedParameter<T>::Set(bool valid, T value) {
+  if (!plain_) {
+    if (parameter_ != nullptr) {
+      parameter_->SetValue(valid, value);
+    }
+    return;
+  }
+  parameter_->StoreValue(valid, ToBits(value));
+}
+
+template <typename T>
+uint64_t TypedParameter<T>::ToBits(T value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return value ? 1 : 0;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return std::bit_cast<uint64_t>(static_cast<double>(value));
+  } else if constexpr (std::is_signed_v<T>) {
+    return std::bit_cast<uint64_t>(static_cast<int64_t>(value));
+  } else {
+    return static_cast<uint64_t>(value);
+  }
+}
+
+template <typename T>
+T TypedParameter<T>::FromBits(uint64_t bits) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return bits != 0;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return static_cast<T>(std::bit_cast<double>(bits));
+  } else if constexpr (std::is_signed_v<T>) {
+    return static_cast<T>(std::bit_cast<int64_t>(bits));
+  } else {
+    return static_cast<T>(bits);
+  }
+}
+
+}  // namespace workflow
@@ -0,0 +1,88 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace workflow {
+
+class Workflow;
+
+/**
+ * @brief Report of a task that exceeded its tick timeout.
+ */
+struct StallReport {
+  std::string workflow; ///< Workflow name.
+  size_t instance = 0; ///< Workflow instance index.
+  std::string task; ///< Task name.
+  uint64_t time = 0; ///< Detection time (ns since 1970).
+  uint64_t duration = 0; ///< Tick duration when detected (ns).
+  size_t thread = 0; ///< Hash of the stalled thread ID.
+};
+
+/**
+ * @class Watchdog
+ *
+ * @brief Detects tasks that are stuck in their Tick() function.
+ *
+ * The watchdog thread checks the attached workflows each period. A task
+ * that has been in its Tick() longer than its timeout (ITask::Timeout()), is
+ * marked as stalled, and a stall report is stored and logged. The stalled
+ * task cannot be stopped but the report identifies the workflow, the task
+ * and the thread that is blocked.
+ */
+class Watchdog {
+ public:
+  Watchdog() = default;
+  virtual ~Watchdog();
+
+  Watchdog(const Watchdog& watchdog) = delete;
+  Watchdog& operator = (const Watchdog& watchdog) = delete;
+
+  void Period(uint64_t period) { period_ = period; }
+  [[nodiscard]] uint64_t Period() const { return period_; } ///< Period (ms)
+
+  /** @brief Attaches a workflow. A workflow is only attached once. */
+  void AttachWorkflow(Workflow* workflow);
+  /** @brief Detaches a workflow. The watchdog never accesses it after. */
+  void DetachWorkflow(const Workflow* workflow);
+  void DetachWorkflows();
+
+  void Start();
+  void Stop();
+  [[nodiscard]] bool IsRunning() const { return working_thread_.joinable(); }
+
+  /**
+   * @brief Checks all attached workflows once.
+   * @param now Current monotonic time (ns). See ITask::SteadyTime().
+   * @return Number of new stalled tasks.
+   */
+  size_t Check(uint64_t now);
+
+  [[nodiscard]] std::vector<StallReport> Reports() const;
+  void ClearReports();
+
+ private:
+  uint64_t period_ = 100; ///< Check period in ms.
+  std::mutex workflow_lock_; ///< Held while the workflows are checked
+  std::vector<Workflow*> workflow_list_;
+  mutable std::mutex report_lock_;
+  std::vector<StallReport> report_list_;
+
+  std::thread working_thread_;
+  std::mutex stop_lock_;
+  std::condition_variable stop_condition_;
+  bool stop_thread_ = true;
+
+  void CheckWorkflow(Workflow& workflow, uint64_t now, size_t& count);
+  void WatchdogTask();
+};
+
+}  // namespace workflow
@@ -11,8 +11,13 @@
 #include <memory>
 #include <any>
 #include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
 
 #include "workflow/itask.h"
+#include "workflow/nameindex.h"
+#include "workflow/configarena.h"
 #include <util/ixmlnode.h>
 #include <util/idirectory.h>
 
@@ -21,17 +26,59 @@ namespace workflow {
 using TaskList = std::vector<std::unique_ptr<ITask>>;
 
 class WorkflowServer;
+class WorkflowPool;
+class WorkflowQueue;
+class Workflow;
+
+/**
+ * @brief Function that modifies the workflow data before a tick.
+ *
+ * The update is run by the thread that runs the tick, so with a strand, it
+ * is serialized with the tasks.
+ */
+using DataUpdate = std::function<void(Workflow& workflow)>;
+
+/** @brief Function that is called for each task in a workflow. */
+using TaskVisitor = std::function<void(Workflow& workflow, ITask& task)>;
+
+/**
+ * @enum StrandPolicy
+ *
+ * @brief Defines how concurrent Tick() calls on a workflow are handled.
+ *
+ * - None: Tick() runs the tasks in the calling thread. Concurrent calls may
+ * run the tasks at the same time.
+ * - Serial: Only one tick runs at a time. A call made while another thread
+ * is ticking, is queued and run by that thread. Each call gives one tick.
+ * - Coalesce: As Serial but all calls made during a tick gives one more tick.
+ */
+enum class StrandPolicy : int {
+  None = 0,
+  Serial,
+  Coalesce
+};
 
 class Workflow {
  public:
   explicit Workflow(WorkflowServer* server);
-  virtual ~Workflow() = default;
+  virtual ~Workflow();
+  static void* operator new(size_t size) {
+    return ConfigArena::Allocate(size);
+  }
+  static void operator delete(void* object) {
+    ConfigArena::Deallocate(object);
+  }
   Workflow(const Workflow& workflow);
   Workflow& operator = (const Workflow& workflow);
 
   [[nodiscard]] bool operator == ( const Workflow& workflow) const;
 
-  void Name(const std::string& name) {name_ = name;}
+  void Name(const std::string& name) {
+    if (name_ != name) {
+      name_ = name;
+      NameIndex::NameChanged();
+    }
+  }
   [[nodiscard]] const std::string& Name() const {return name_;}
 
   void Description(const std::string& desc) {description_ = desc;}
@@ -42,7 +89,30 @@ class Workflow {
     return start_event_;
   }
 
-  [[nodiscard]] TaskList& Tasks() {return task_list_;}
+  /**
+   * @brief Number of parallel instances of the workflow.
+   *
+   * If the number of instances is larger than 1, the Init() function
+   * creates a pool of instances, each with its own tasks and data. The
+   * Tick() function then ticks all instances in parallel instead of
+   * the workflow own tasks.
+   * @param instances Number of instances.
+   */
+  void Instances(size_t instances) {instances_ = instances;}
+  [[nodiscard]] size_t Instances() const {return instances_;}
+  [[nodiscard]] size_t InstanceIndex() const {return instance_index_;}
+  [[nodiscard]] WorkflowPool* Pool() {return pool_.get();}
+  [[nodiscard]] Workflow* SelectInstance(const std::string& key);
+  [[nodiscard]] std::unique_ptr<Workflow> CreateInstance(size_t index) const;
+  [[nodiscard]] const WorkflowServer* GetServer() const {return server_;}
+
+  /** @brief Returns the task list. The caller may change it directly. */
+  [[nodiscard]] TaskList& Tasks() {
+    task_index_.Invalidate();
+    template_index_.Invalidate();
+    return task_list_;
+  }
+  [[nodiscard]] const TaskList& Tasks() const {return task_list_;}
   [[nodiscard]] const ITask* GetTask(const std::string& name) const;
   [[nodiscard]] ITask* GetTask(const std::string& name);
   void AddTask(const ITask& task);
@@ -52,14 +122,99 @@ class Workflow {
   virtual void OnStart();
   [[nodiscard]] bool IsRunning() const {return running_;}
 
+  /**
+   * @brief Enables incremental execution of the tasks.
+   *
+   * In incremental mode, a task that has declared inputs (see
+   * ITask::HasInputs()) is only ticked if any of its inputs changed since
+   * its last successful tick. Tasks without inputs are always ticked.
+   * @param incremental True if incremental mode.
+   */
+  void Incremental(bool incremental) {incremental_ = incremental;}
+  [[nodiscard]] bool Incremental() const {return incremental_;}
+
+  /**
+   * @brief Serializes the ticks of the workflow.
+   *
+   * A workflow that is started from more than one thread, should use a
+   * strand, so the tasks and the workflow data are only accessed by one
+   * thread at a time. Note that with a strand, a Tick() call may return
+   * before its tick is done, as the tick is run by the thread that currently
+   * ticks the workflow.
+   * @param policy Strand policy.
+   */
+  void Strand(StrandPolicy policy) {strand_ = policy;}
+  [[nodiscard]] StrandPolicy Strand() const {return strand_;}
+  void StrandAsString(const std::string& policy);
+  [[nodiscard]] std::string StrandAsString() const;
+
+  /**
+   * @brief Checkpoint file for the workflow data.
+   *
+   * If a checkpoint file is defined, the workflow data is restored from the
+   * file in Init() and saved to the file in Exit(). Only data types that are
+   * registered in the DataCheckpoint are saved.
+   * @param filename Full path to the checkpoint file.
+   */
+  void Checkpoint(const std::string& filename) {checkpoint_ = filename;}
+  [[nodiscard]] const std::string& Checkpoint() const {return checkpoint_;}
+
+  /** @brief Period (s) for saving checkpoints in Tick(). 0 = only Exit(). */
+  void CheckpointPeriod(uint64_t period) {checkpoint_period_ = period;}
+  [[nodiscard]] uint64_t CheckpointPeriod() const {
+    return checkpoint_period_;
+  }
+  bool SaveCheckpoint();
+  bool RestoreCheckpoint();
+
+  /** @brief Returns true if any task is stalled in its Tick(). */
+  [[nodiscard]] bool Stalled() const;
+
+  /**
+   * @brief Calls the visitor for each task, including the instance tasks.
+   *
+   * Used by the watchdog thread. The task list and the instance pool are
+   * locked during the call, so they are not changed or deleted by Init(),
+   * Exit() or the task list functions meanwhile. Changes made directly on
+   * the Tasks() list are not guarded.
+   * @param visitor Function to call for each task.
+   */
+  void VisitTasks(const TaskVisitor& visitor);
+
+  [[nodiscard]] uint64_t NofTaskRuns() const {return nof_task_runs_;}
+  [[nodiscard]] uint64_t NofTaskSkips() const {return nof_task_skips_;}
+  [[nodiscard]] uint64_t NofTriggers() const {return nof_triggers_;}
+  [[nodiscard]] uint64_t NofCoalesced() const {return nof_coalesced_;}
+  void ResetStatistics();
+
   virtual void SaveXml(util::xml::IXmlNode& root) const;
   virtual void ReadXml(const util::xml::IXmlNode& root);
 
   void MoveUp(const ITask* task);
   void MoveDown(const ITask* task);
 
+  /**
+   * @brief Rebuilds the task name index.
+   *
+   * The index is rebuilt by the functions that change the task list and by
+   * Init(). A renamed task or a change made through Tasks() makes the index
+   * stale, and GetTask() then scans the list on a miss until it is rebuilt.
+   */
+  void BuildIndex();
+
   void Init();
   void Tick(); ///< Runs all runners/tasks
+  /**
+   * @brief Updates the workflow data and runs the tasks.
+   *
+   * Use this function instead of writing the workflow data and calling
+   * Tick(), when the workflow is triggered from more than one thread. With
+   * a strand, the update is queued together with its tick, so it isn't
+   * overwritten by another thread before the tasks have consumed it. A tick
+   * with an update is never coalesced.
+   * @param update Function that modifies the workflow data.
+   */
+  void Tick(DataUpdate update);
   void Exit();
 
   template<typename T>
@@ -70,7 +225,13 @@ class Workflow {
 
   void ClearData();
 
+  /** @brief Change counter of the workflow data. */
+  [[nodiscard]] uint64_t DataVersion() const {return data_version_;}
+  /** @brief Tasks that modify the workflow data shall call this function. */
+  void DataChanged() {++data_version_;}
+
   [[nodiscard]] Workflow* GetWorkflow(const std::string& schedule_name);
+  [[nodiscard]] WorkflowQueue* GetQueue(const std::string& queue_name);
 
  protected:
   std::atomic<bool> start_ = false;
@@ -85,6 +246,36 @@ class Workflow {
   std::string description_;
   std::string start_event_;
   std::any data_;
+  std::atomic<uint64_t> data_version_ = 0;
+
+  bool incremental_ = false;
+  size_t instances_ = 1;
+  size_t instance_index_ = 0;
+  std::unique_ptr<WorkflowPool> pool_;
+  /// Guards the task list and the pool against the watchdog thread.
+  mutable std::mutex task_lock_;
+
+  StrandPolicy strand_ = StrandPolicy::None;
+  std::string checkpoint_; ///< Checkpoint file name
+  uint64_t checkpoint_period_ = 0; ///< Checkpoint period in seconds
+  uint64_t last_checkpoint_ = 0; ///< Monotonic time of last checkpoint (ns)
+  std::atomic<uint64_t> pending_ = 0; ///< Number of pending strand ticks
+  std::mutex update_lock_;
+  std::deque<DataUpdate> update_list_; ///< Pending strand data updates
+
+  std::atomic<uint64_t> nof_task_runs_ = 0;
+  std::atomic<uint64_t> nof_task_skips_ = 0;
+  std::atomic<uint64_t> nof_triggers_ = 0;
+  std::atomic<uint64_t> nof_coalesced_ = 0;
+
+  NameIndex task_index_; ///< Task name to position in task list
+  NameIndex template_index_; ///< Template name to position in task list
+
+  [[nodiscard]] size_t FindTask(const std::string& name) const;
+  [[nodiscard]] size_t FindTemplate(const std::string& name) const;
+  void RunStrand();
+  void TickTasks();
+  void TickTask(ITask& task);
 };
 
 template <typename T>
@@ -105,6 +296,7 @@ template <typename T>
 bool Workflow::InitData(const T& value) {
   try {
     data_ = std::make_any<T>(value);
+    DataChanged();
   } catch (const std::exception&) {
     return false;
   }
@@ -0,0 +1,96 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "workflow/workflow.h"
+
+namespace workflow {
+
+/**
+ * @brief Function that returns the instance index for a partition key.
+ *
+ * The function shall return a value less than the number of instances.
+ */
+using PartitionFunction = std::function<size_t(const std::string& key,
+                                               size_t nof_instances)>;
+using InstanceJob = std::function<void(Workflow& instance, size_t index)>;
+
+/**
+ * @class WorkflowPool
+ *
+ * @brief Runs identical instances of a workflow in parallel.
+ *
+ * The pool creates a number of instances of a workflow definition. Each
+ * instance has its own tasks and workflow data, and its own worker thread.
+ * The Tick() function ticks all instances in parallel and waits until all of
+ * them are done.
+ *
+ * Work is distributed over the instances with a partition key, for example
+ * the source host of a syslog message. The default partition function hashes
+ * the key, but it can be replaced with SetPartitionFunction().
+ */
+class WorkflowPool {
+ public:
+  WorkflowPool() = default;
+  virtual ~WorkflowPool();
+
+  WorkflowPool(const WorkflowPool& pool) = delete;
+  WorkflowPool& operator = (const WorkflowPool& pool) = delete;
+
+  void Create(const Workflow& definition, size_t nof_instances);
+  [[nodiscard]] size_t Size() const { return instance_list_.size(); }
+  [[nodiscard]] Workflow* Instance(size_t index);
+
+  void SetPartitionFunction(PartitionFunction function);
+  [[nodiscard]] size_t Partition(const std::string& key) const;
+  [[nodiscard]] Workflow* Select(const std::string& key);
+
+  /**
+   * @brief Runs a job on all instances in parallel.
+   *
+   * The job is called once per instance from the instance worker thread.
+   * The function returns when all instances are done.
+   * @param job Function to run on each instance.
+   */
+  void Run(const InstanceJob& job);
+
+  /**
+   * @brief Initializes the instances, their tasks and starts the threads.
+   *
+   * The tasks of each instance are initialized by the pool, as they are
+   * not known by the server.
+   */
+  void Init();
+  void Tick(); ///< Ticks all instances in parallel.
+  void Exit(); ///< Stops the threads and exits the tasks and instances.
+
+ private:
+  std::vector<std::unique_ptr<Workflow>> instance_list_;
+  PartitionFunction partition_function_;
+
+  std::vector<std::thread> thread_list_;
+  std::mutex run_lock_; ///< Only one job at a time
+  std::mutex job_lock_;
+  std::condition_variable job_condition_;
+  std::condition_variable done_condition_;
+  const InstanceJob* job_ = nullptr;
+  uint64_t job_id_ = 0;
+  size_t nof_running_ = 0;
+  bool stop_thread_ = true;
+  bool init_ = false; ///< True if the instances are initialized
+
+  void WorkerTask(size_t index, uint64_t last_job);
+};
+
+}  // namespace workflow
@@ -0,0 +1,42 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <memory>
+
+#include "workflow/workflow.h"
+
+namespace workflow {
+
+/**
+ * @class WorkflowPrototype
+ *
+ * @brief Compiled workflow definition that is cheap to instantiate.
+ *
+ * The prototype is created once from a workflow definition. The plain task
+ * templates in the definition are converted to task objects of the right
+ * type by the server task factories, which also parses the task arguments.
+ * This is the expensive part and it is only done once.
+ *
+ * The Instantiate() function then creates new workflow instances by
+ * cloning the compiled tasks. The prototype itself is never initialized or
+ * ticked, so it can be shared between threads.
+ */
+class WorkflowPrototype {
+ public:
+  explicit WorkflowPrototype(const Workflow& definition);
+  virtual ~WorkflowPrototype() = default;
+
+  WorkflowPrototype(const WorkflowPrototype& prototype) = delete;
+  WorkflowPrototype& operator = (const WorkflowPrototype& prototype) = delete;
+
+  [[nodiscard]] const Workflow& Definition() const {return *definition_;}
+  [[nodiscard]] std::unique_ptr<Workflow> Instantiate(size_t index) const;
+
+ private:
+  std::unique_ptr<Workflow> definition_; ///< Compiled definition
+};
+
+}  // namespace workflow
@@ -0,0 +1,165 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+#include <any>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace util::xml {
+
+class IXmlNode;
+
+} // end namespace util::xml
+
+namespace workflow {
+
+/**
+ * @enum DropPolicy
+ *
+ * @brief Defines what happens when an item is pushed to a full queue.
+ *
+ * - DropNewest: The pushed item is dropped.
+ * - DropOldest: The oldest item in the queue is dropped.
+ * - Block: The producer waits until there is room in the queue.
+ */
+enum class DropPolicy : int {
+  DropNewest = 0,
+  DropOldest,
+  Block
+};
+
+/**
+ * @class WorkflowQueue
+ *
+ * @brief Named bounded queue between a producer and a consumer workflow.
+ *
+ * The queue is a lock-free ring buffer with a fixed capacity. Any number of
+ * producers and consumers may push and pop items concurrently. The consumer
+ * workflow is normally started by a queue event (EventType::Queue) that
+ * ticks the workflow on its own thread when items are available. The
+ * producer does not wait for the consumer unless the drop policy is Block.
+ *
+ * The capacity and drop policy cannot be changed after Init().
+ */
+class WorkflowQueue {
+ public:
+  WorkflowQueue() = default;
+  virtual ~WorkflowQueue() = default;
+
+  WorkflowQueue(const WorkflowQueue& queue);
+  WorkflowQueue& operator = (const WorkflowQueue& queue) = delete;
+  [[nodiscard]] bool operator == (const WorkflowQueue& queue) const;
+
+  void Name(const std::string& name) { name_ = name; }
+  [[nodiscard]] const std::string& Name() const { return name_; }
+
+  void Description(const std::string& desc) { description_ = desc; }
+  [[nodiscard]] const std::string& Description() const {
+    return description_;
+  }
+
+  void Capacity(size_t capacity) { capacity_ = capacity; }
+  [[nodiscard]] size_t Capacity() const { return capacity_; }
+
+  void Policy(DropPolicy policy) { policy_ = policy; }
+  [[nodiscard]] DropPolicy Policy() const { return policy_; }
+  void PolicyAsString(const std::string& policy);
+  [[nodiscard]] std::string PolicyAsString() const;
+
+  /**
+   * @brief Pushes an item to the queue.
+   * @param item Item to push.
+   * @return False if the item was dropped.
+   */
+  bool Push(std::any&& item);
+  [[nodiscard]] bool Pop(std::any& item);
+
+  template <typename T>
+  bool Push(T item) {
+    return Push(std::make_any<T>(std::move(item)));
+  }
+
+  template <typename T>
+  [[nodiscard]] bool Pop(T& item);
+
+  [[nodiscard]] size_t Depth() const; ///< Number of items in the queue.
+  [[nodiscard]] bool Empty() const { return Depth() == 0; }
+  [[nodiscard]] size_t MaxDepth() const { return max_depth_; }
+  [[nodiscard]] uint64_t NofPushed() const { return nof_pushed_; }
+  [[nodiscard]] uint64_t NofPopped() const { return nof_popped_; }
+  [[nodiscard]] uint64_t NofDropped() const { return nof_dropped_; }
+  void ResetStatistics();
+
+  /**
+   * @brief Waits until items are pushed or Wake() is called.
+   *
+   * Only used by the consumer. The function waits for a push that is made
+   * after the previous call, not for a non-empty queue, so a consumer that
+   * leaves items in the queue isn't woken again until the next push. The
+   * function may return without items, so the caller should call it in a
+   * loop. The caller shall set the cancel flag before calling Wake(), when
+   * it wants to stop waiting.
+   * @param cancel The function doesn't wait if this flag is set.
+   * @param signal Signal value that the consumer last handled. Start with
+   * 0. The function updates it.
+   * @return True if the queue has items.
+   */
+  bool WaitForItems(const std::atomic<bool>& cancel, uint64_t& signal);
+  void Wake(); ///< Wakes a waiting consumer.
+
+  void Init(); ///< Allocates the ring buffer.
+  void Exit(); ///< Releases blocked producers and the consumer.
+
+  void SaveXml(util::xml::IXmlNode& root) const;
+  void ReadXml(const util::xml::IXmlNode& root);
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence = 0;
+    std::any item;
+  };
+
+  std::string name_;
+  std::string description_;
+  size_t capacity_ = 1024; ///< Max number of items in the queue.
+  DropPolicy policy_ = DropPolicy::DropNewest;
+
+  std::unique_ptr<Cell[]> cell_list_; ///< Ring buffer (power of 2 size).
+  size_t mask_ = 0;
+  std::atomic<bool> active_ = false;
+  alignas(64) std::atomic<size_t> write_pos_ = 0;
+  alignas(64) std::atomic<size_t> read_pos_ = 0;
+  alignas(64) std::atomic<uint64_t> signal_ = 0; ///< Push counter
+  std::atomic<bool> waiting_ = false;
+  alignas(64) std::atomic<uint64_t> pop_signal_ = 0; ///< Pop counter
+  std::atomic<size_t> nof_blocked_ = 0; ///< Producers waiting for a pop
+
+  std::atomic<size_t> max_depth_ = 0;
+  std::atomic<uint64_t> nof_pushed_ = 0;
+  std::atomic<uint64_t> nof_popped_ = 0;
+  std::atomic<uint64_t> nof_dropped_ = 0;
+
+  bool TryPush(std::any& item);
+  bool TryPop(std::any& item);
+};
+
+template <typename T>
+bool WorkflowQueue::Pop(T& item) {
+  std::any temp;
+  if (!Pop(temp)) {
+    return false;
+  }
+  try {
+    item = std::any_cast<T>(std::move(temp));
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace workflow
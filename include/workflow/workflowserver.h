@@ -14,6 +14,10 @@
 #include "workflow/workflow.h"
 #include "workflow/itask.h"
 #include "workflow/itaskfactory.h"
+#include "workflow/watchdog.h"
+#include "workflow/workflowqueue.h"
+#include "workflow/nameindex.h"
+#include "workflow/configarena.h"
 
 #include <util/ixmlnode.h>
 #include <util/stringutil.h>
@@ -22,6 +26,8 @@ namespace workflow {
 
 using WorkflowList = std::vector<std::unique_ptr<Workflow>>;
 using TaskFactoryList = std::vector<const ITaskFactory*>;
+using QueueList = std::map<std::string, std::unique_ptr<WorkflowQueue>,
+      util::string::IgnoreCase>;
 
 using PropertyList = std::map<std::string, std::string,
       util::string::IgnoreCase>;
@@ -50,16 +56,51 @@ class WorkflowServer {
   [[nodiscard]] EventEngine* GetEventEngine();
   [[nodiscard]] const EventEngine* GetEventEngine() const;
 
-  [[nodiscard]] WorkflowList& Workflows() {return workflow_list_;}
+  /**
+   * @brief Allocates the configuration objects in an arena.
+   *
+   * In arena mode, the workflows, tasks, events, devices and parameters
+   * created by ReadXml() are allocated from a few large memory blocks. The
+   * blocks are freed at once by Clear().
+   * @param arena_mode True if arena mode.
+   */
+  void ArenaMode(bool arena_mode);
+  [[nodiscard]] bool ArenaMode() const {return static_cast<bool>(arena_);}
+  [[nodiscard]] const ConfigArena* GetArena() const {return arena_.get();}
+
+  [[nodiscard]] Watchdog& GetWatchdog() {return watchdog_;}
+  [[nodiscard]] const Watchdog& GetWatchdog() const {return watchdog_;}
+
+  /** @brief Returns the workflow list. The caller may change it directly. */
+  [[nodiscard]] WorkflowList& Workflows() {
+    workflow_index_.Invalidate();
+    return workflow_list_;
+  }
   [[nodiscard]] const WorkflowList& Workflows() const {return workflow_list_;}
   void AddWorkflow(const Workflow& workflow);
   void DeleteWorkflow(const Workflow* workflow);
   [[nodiscard]] const Workflow* GetWorkflow(const std::string& name) const;
   [[nodiscard]] Workflow* GetWorkflow(const std::string& name);
 
+  [[nodiscard]] QueueList& Queues() {return queue_list_;}
+  [[nodiscard]] const QueueList& Queues() const {return queue_list_;}
+  void AddQueue(const WorkflowQueue& queue);
+  void DeleteQueue(const WorkflowQueue* queue);
+  [[nodiscard]] const WorkflowQueue* GetQueue(const std::string& name) const;
+  [[nodiscard]] WorkflowQueue* GetQueue(const std::string& name);
+
   void MoveUp(const Workflow* workflow);
   void MoveDown(const Workflow* workflow);
 
+  /**
+   * @brief Rebuilds the workflow name index.
+   *
+   * A renamed workflow or a change made through Workflows() makes the index
+   * stale, and GetWorkflow() then scans the list on a miss until it is
+   * rebuilt.
+   */
+  void BuildIndex();
+
   [[nodiscard]] const std::vector<const ITaskFactory*>& Factories() const;;
   [[nodiscard]] std::map<std::string, const ITask*> Templates() const;
   [[nodiscard]] const ITask* GetTemplate(const std::string& name) const;
@@ -98,11 +139,18 @@ class WorkflowServer {
  private:
   std::string name_;
   std::string description_;
+  /// The arena shall be destroyed after all objects in it.
+  std::unique_ptr<ConfigArena> arena_;
   std::unique_ptr<ParameterContainer> parameter_container_;
   std::unique_ptr<EventEngine> event_engine_;
   WorkflowList workflow_list_;
+  NameIndex workflow_index_; ///< Workflow name to position in list
+  QueueList queue_list_; ///< Queues between workflows
   TaskFactoryList factory_list_; ///< List of available task factories
   PropertyList property_list_; ///< Application tag properties
+  Watchdog watchdog_; ///< Detects stalled tasks
+
+  [[nodiscard]] size_t FindWorkflow(const std::string& name) const;
 };
 
 template <typename T>
@@ -0,0 +1,99 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/bufferpool.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace workflow {
+
+struct BufferPool::State {
+  explicit State(size_t max) : max_buffers(max) {}
+
+  void Release(ByteArray* buffer) {
+    std::unique_ptr<ByteArray> temp(buffer);
+    std::scoped_lock lock(free_lock);
+    if (free_list.size() < max_buffers) {
+      free_list.emplace_back(std::move(temp));
+    }
+  }
+
+  const size_t max_buffers;
+  mutable std::mutex free_lock;
+  std::vector<std::unique_ptr<ByteArray>> free_list;
+  std::atomic<uint64_t> nof_allocations = 0;
+  std::atomic<uint64_t> nof_reuses = 0;
+};
+
+BufferPool::BufferPool(size_t max_buffers)
+: state_(std::make_shared<State>(max_buffers)) {
+}
+
+BufferPool& BufferPool::Default() {
+  static BufferPool pool;
+  return pool;
+}
+
+std::shared_ptr<ByteArray> BufferPool::Acquire(size_t size) {
+  std::unique_ptr<ByteArray> buffer;
+  {
+    // Use the smallest free buffer that is large enough
+    std::scoped_lock lock(state_->free_lock);
+    auto& free_list = state_->free_list;
+    auto best = free_list.end();
+    for (auto itr = free_list.begin(); itr != free_list.end(); ++itr) {
+      const size_t capacity = (*itr)->capacity();
+      if (capacity >= size &&
+          (best == free_list.end() || capacity < (*best)->capacity())) {
+        best = itr;
+      }
+    }
+    if (best != free_list.end()) {
+      buffer = std::move(*best);
+      *best = std::move(free_list.back());
+      free_list.pop_back();
+    }
+  }
+  if (buffer) {
+    ++state_->nof_reuses;
+  } else {
+    buffer = std::make_unique<ByteArray>();
+    ++state_->nof_allocations;
+  }
+  buffer->resize(size);
+
+  auto state = state_;
+  return {buffer.release(), [state] (ByteArray* array) {
+    state->Release(array);
+  }};
+}
+
+SharedBuffer BufferPool::Copy(const uint8_t* data, size_t size) {
+  auto buffer = Acquire(size);
+  if (size > 0) {
+    memcpy(buffer->data(), data, size);
+  }
+  return buffer;
+}
+
+size_t BufferPool::MaxBuffers() const {
+  return state_->max_buffers;
+}
+
+size_t BufferPool::NofFree() const {
+  std::scoped_lock lock(state_->free_lock);
+  return state_->free_list.size();
+}
+
+uint64_t BufferPool::NofAllocations() const {
+  return state_->nof_allocations;
+}
+
+uint64_t BufferPool::NofReuses() const {
+  return state_->nof_reuses;
+}
+
+}  // namespace workflow
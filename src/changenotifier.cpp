@@ -0,0 +1,191 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/changenotifier.h"
+#include <algorithm>
+#include <ranges>
+#include "workflow/workflowqueue.h"
+
+namespace {
+
+struct Batch {
+  workflow::ChangeNotifier* owner = nullptr;
+  workflow::ChangeList change_list;
+};
+
+/// Active batches in this thread. The last one is the innermost.
+thread_local std::vector<Batch> batch_stack;
+
+/// Subscriber whose callback runs in this thread.
+thread_local const void* calling_subscriber = nullptr;
+
+Batch* FindBatch(const workflow::ChangeNotifier* owner) {
+  const auto itr = std::ranges::find(batch_stack | std::views::reverse,
+                                     owner, &Batch::owner);
+  return itr != (batch_stack | std::views::reverse).end() ? &*itr : nullptr;
+}
+
+}
+
+namespace workflow {
+
+size_t ChangeNotifier::Subscribe(ChangeCallback callback,
+                                 const ChangeList& filter) {
+  if (!callback) {
+    return 0;
+  }
+  auto subscriber = std::make_shared<Subscriber>();
+  subscriber->callback = std::move(callback);
+  subscriber->filter.insert(filter.cbegin(), filter.cend());
+  return AddSubscriber(std::move(subscriber));
+}
+
+size_t ChangeNotifier::Subscribe(WorkflowQueue& queue,
+                                 const ChangeList& filter) {
+  auto subscriber = std::make_shared<Subscriber>();
+  subscriber->queue = &queue;
+  subscriber->filter.insert(filter.cbegin(), filter.cend());
+  return AddSubscriber(std::move(subscriber));
+}
+
+size_t ChangeNotifier::AddSubscriber(std::shared_ptr<Subscriber> subscriber) {
+  std::scoped_lock lock(subscriber_lock_);
+  subscriber->subscription = ++last_subscription_;
+  const size_t subscription = subscriber->subscription;
+  subscriber_list_.push_back(std::move(subscriber));
+  nof_subscribers_ = subscriber_list_.size();
+  return subscription;
+}
+
+void ChangeNotifier::Unsubscribe(size_t subscription) {
+  std::shared_ptr<Subscriber> removed;
+  {
+    std::scoped_lock lock(subscriber_lock_);
+    const auto itr = std::ranges::find_if(subscriber_list_,
+                                          [&] (const auto& subscriber) {
+      return subscriber && subscriber->subscription == subscription;
+    });
+    if (itr == subscriber_list_.end()) {
+      return;
+    }
+    removed = *itr;
+    subscriber_list_.erase(itr);
+    nof_subscribers_ = subscriber_list_.size();
+  }
+  // A running dispatch may still hold the subscriber. Wait for its callback
+  // to return, unless it is the callback that unsubscribes.
+  removed->active = false;
+  if (calling_subscriber != removed.get()) {
+    std::scoped_lock call_lock(removed->call_lock);
+  }
+}
+
+void ChangeNotifier::Changed(Parameter& parameter) {
+  ++nof_changes_;
+  // Only the first change in a cycle is queued.
+  if (parameter.pending_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  if (!batch_stack.empty()) {
+    if (auto* batch = FindBatch(this); batch != nullptr) {
+      batch->change_list.push_back(&parameter);
+      return;
+    }
+  }
+  std::scoped_lock lock(change_lock_);
+  change_list_.push_back(&parameter);
+}
+
+void ChangeNotifier::BeginBatch() {
+  batch_stack.push_back({this, {}});
+}
+
+void ChangeNotifier::EndBatch() {
+  if (batch_stack.empty() || batch_stack.back().owner != this) {
+    return;
+  }
+  ChangeList change_list = std::move(batch_stack.back().change_list);
+  batch_stack.pop_back();
+  if (change_list.empty()) {
+    return;
+  }
+  if (auto* outer = FindBatch(this); outer != nullptr) {
+    outer->change_list.insert(outer->change_list.end(), change_list.cbegin(),
+                              change_list.cend());
+    return;
+  }
+  std::scoped_lock lock(change_lock_);
+  change_list_.insert(change_list_.end(), change_list.cbegin(),
+                      change_list.cend());
+}
+
+void ChangeNotifier::Remove(const Parameter* parameter) {
+  std::scoped_lock lock(change_lock_);
+  std::erase(change_list_, parameter);
+}
+
+size_t ChangeNotifier::Dispatch() {
+  ChangeList change_list;
+  {
+    std::scoped_lock lock(change_lock_);
+    change_list.swap(change_list_);
+  }
+  if (change_list.empty()) {
+    return 0;
+  }
+  // Clear the pending flags before any subscriber reads the values, so a
+  // change during the dispatch is reported in the next cycle.
+  for (auto* parameter : change_list) {
+    parameter->pending_.store(false, std::memory_order_release);
+  }
+
+  // The callbacks are called without the lock, so a slow subscriber doesn't
+  // block subscription changes.
+  SubscriberList subscriber_list;
+  {
+    std::scoped_lock lock(subscriber_lock_);
+    subscriber_list = subscriber_list_;
+  }
+
+  size_t nof_notifications = 0;
+  ChangeList filter_list;
+  for (const auto& subscriber : subscriber_list) {
+    if (!subscriber) {
+      continue;
+    }
+    // Unsubscribe() waits on the call lock, so the subscriber isn't called
+    // after it returns.
+    std::unique_lock call_lock(subscriber->call_lock);
+    if (!subscriber->active) {
+      continue;
+    }
+    const ChangeList* notify_list = &change_list;
+    if (!subscriber->filter.empty()) {
+      filter_list.clear();
+      for (auto* parameter : change_list) {
+        if (subscriber->filter.contains(parameter)) {
+          filter_list.push_back(parameter);
+        }
+      }
+      notify_list = &filter_list;
+    }
+    if (notify_list->empty()) {
+      continue;
+    }
+    if (subscriber->callback) {
+      const void* caller = calling_subscriber;
+      calling_subscriber = subscriber.get();
+      subscriber->callback(*notify_list);
+      calling_subscriber = caller;
+    } else if (subscriber->queue != nullptr) {
+      subscriber->queue->Push(ChangeList(*notify_list));
+    }
+    ++nof_notifications;
+  }
+  nof_notifications_ += nof_notifications;
+  return nof_notifications;
+}
+
+}  // namespace workflow
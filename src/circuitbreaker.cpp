@@ -0,0 +1,171 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/circuitbreaker.h"
+#include <algorithm>
+#include <cmath>
+#include <util/ixmlnode.h>
+
+using namespace util::xml;
+
+namespace {
+
+constexpr size_t kMaxTransitions = 32; ///< Number of stored transitions
+
+}
+
+namespace workflow {
+
+CircuitBreaker::CircuitBreaker(const CircuitBreaker& breaker)
+: max_failures_(breaker.max_failures_),
+  min_backoff_(breaker.min_backoff_),
+  max_backoff_(breaker.max_backoff_),
+  jitter_(breaker.jitter_) {
+}
+
+CircuitBreaker& CircuitBreaker::operator=(const CircuitBreaker& breaker) {
+  if (this == &breaker) {
+    return *this;
+  }
+  max_failures_ = breaker.max_failures_;
+  min_backoff_ = breaker.min_backoff_;
+  max_backoff_ = breaker.max_backoff_;
+  jitter_ = breaker.jitter_;
+  Reset();
+  return *this;
+}
+
+bool CircuitBreaker::operator==(const CircuitBreaker& breaker) const {
+  if (max_failures_ != breaker.max_failures_) return false;
+  if (min_backoff_ != breaker.min_backoff_) return false;
+  if (max_backoff_ != breaker.max_backoff_) return false;
+  if (jitter_ != breaker.jitter_) return false;
+  return true;
+}
+
+std::string CircuitBreaker::StateAsString() const {
+  switch (state_) {
+    case CircuitState::Closed:
+      return "Closed";
+
+    case CircuitState::Open:
+      return "Open";
+
+    case CircuitState::HalfOpen:
+      return "Half-Open";
+
+    default:
+      break;
+  }
+  return {};
+}
+
+bool CircuitBreaker::AllowTick(uint64_t now) {
+  switch (state_) {
+    case CircuitState::Open:
+      if (now < next_probe_) {
+        return false;
+      }
+      ChangeState(CircuitState::HalfOpen, now);
+      return true;
+
+    case CircuitState::HalfOpen:
+    case CircuitState::Closed:
+    default:
+      break;
+  }
+  return true;
+}
+
+void CircuitBreaker::Success(uint64_t now) {
+  failures_ = 0;
+  nof_opens_ = 0;
+  if (state_ != CircuitState::Closed) {
+    ChangeState(CircuitState::Closed, now);
+  }
+}
+
+void CircuitBreaker::Failure(uint64_t now) {
+  ++failures_;
+  if (!Enabled()) {
+    return;
+  }
+  switch (state_) {
+    case CircuitState::HalfOpen:
+      // The probe failed. Open again with a longer backoff.
+      Open(now);
+      break;
+
+    case CircuitState::Closed:
+      if (failures_ >= max_failures_) {
+        Open(now);
+      }
+      break;
+
+    case CircuitState::Open:
+    default:
+      break;
+  }
+}
+
+void CircuitBreaker::Reset() {
+  state_ = CircuitState::Closed;
+  failures_ = 0;
+  nof_opens_ = 0;
+  next_probe_ = 0;
+  transition_list_.clear();
+}
+
+void CircuitBreaker::Open(uint64_t now) {
+  // Exponential backoff min * 2^n limited by the max backoff.
+  const auto exponent = static_cast<double>(std::min(nof_opens_,
+                                                     size_t{62}));
+  double backoff = std::min(min_backoff_ * std::pow(2.0, exponent),
+                            max_backoff_);
+  ++nof_opens_;
+
+  if (jitter_ > 0.0) {
+    std::uniform_real_distribution<double> dist(-jitter_, jitter_);
+    backoff *= 1.0 + dist(random_);
+  }
+  backoff = std::max(backoff, 0.0);
+  next_probe_ = now + static_cast<uint64_t>(backoff * 1'000'000'000.0);
+  ChangeState(CircuitState::Open, now);
+}
+
+void CircuitBreaker::ChangeState(CircuitState state, uint64_t now) {
+  if (transition_list_.size() >= kMaxTransitions) {
+    transition_list_.erase(transition_list_.begin());
+  }
+  CircuitTransition transition;
+  transition.time = now;
+  transition.from = state_;
+  transition.to = state;
+  transition.failures = failures_;
+  transition_list_.emplace_back(transition);
+  state_ = state;
+}
+
+void CircuitBreaker::SaveXml(IXmlNode& root) const {
+  auto& breaker_root = root.AddNode("CircuitBreaker");
+  breaker_root.SetProperty("MaxFailures", max_failures_);
+  breaker_root.SetProperty("MinBackoff", min_backoff_);
+  breaker_root.SetProperty("MaxBackoff", max_backoff_);
+  breaker_root.SetProperty("Jitter", jitter_);
+}
+
+void CircuitBreaker::ReadXml(const IXmlNode& root) {
+  const auto* breaker_root = root.GetNode("CircuitBreaker");
+  if (breaker_root == nullptr) {
+    return;
+  }
+  max_failures_ = breaker_root->Property<size_t>("MaxFailures", 0);
+  min_backoff_ = breaker_root->Property<double>("MinBackoff", 1.0);
+  max_backoff_ = breaker_root->Property<double>("MaxBackoff", 300.0);
+  jitter_ = breaker_root->Property<double>("Jitter", 0.1);
+  Reset();
+}
+
+}  // namespace workflow
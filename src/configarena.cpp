@@ -0,0 +1,78 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/configarena.h"
+#include <new>
+
+namespace {
+
+// Each object is prefixed with a header, that tells if the object is in an
+// arena. The header size keeps the object aligned.
+struct ObjectHeader {
+  workflow::ConfigArena* arena = nullptr;
+};
+
+constexpr size_t kHeaderSize = alignof(std::max_align_t) > sizeof(ObjectHeader)
+    ? alignof(std::max_align_t) : sizeof(ObjectHeader);
+
+thread_local workflow::ConfigArena* current_arena = nullptr;
+
+}
+
+namespace workflow {
+
+bool ConfigArena::Release() {
+  if (nof_objects_ > 0) {
+    return false;
+  }
+  resource_.release();
+  nof_bytes_ = 0;
+  return true;
+}
+
+void* ConfigArena::Allocate(size_t size) {
+  auto* arena = current_arena;
+  void* memory = nullptr;
+  if (arena != nullptr) {
+    memory = arena->resource_.allocate(size + kHeaderSize,
+                                       alignof(std::max_align_t));
+    ++arena->nof_objects_;
+    arena->nof_bytes_ += size + kHeaderSize;
+  } else {
+    memory = ::operator new(size + kHeaderSize);
+  }
+  auto* header = new (memory) ObjectHeader;
+  header->arena = arena;
+  return static_cast<std::byte*>(memory) + kHeaderSize;
+}
+
+void ConfigArena::Deallocate(void* object) noexcept {
+  if (object == nullptr) {
+    return;
+  }
+  void* memory = static_cast<std::byte*>(object) - kHeaderSize;
+  const auto* header = static_cast<const ObjectHeader*>(memory);
+  if (header->arena != nullptr) {
+    // The memory is freed by Release()
+    --header->arena->nof_objects_;
+  } else {
+    ::operator delete(memory);
+  }
+}
+
+ConfigArena* ConfigArena::Current() {
+  return current_arena;
+}
+
+ConfigArenaScope::ConfigArenaScope(ConfigArena* arena)
+: previous_(current_arena) {
+  current_arena = arena;
+}
+
+ConfigArenaScope::~ConfigArenaScope() {
+  current_arena = previous_;
+}
+
+}  // namespace workflow
@@ -0,0 +1,278 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/datacheckpoint.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+#include <util/syslogmessage.h>
+
+using util::syslog::SyslogMessage;
+using SyslogList = std::vector<SyslogMessage>;
+
+namespace {
+
+constexpr std::string_view kMagic = "WFCP";
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kMaxStringSize = 1'000'000'000;
+
+template <typename T>
+void RegisterNumber(workflow::DataCheckpoint& checkpoint,
+                    const std::string& name) {
+  checkpoint.RegisterType<T>(name,
+      [] (const T& data, workflow::CheckpointWriter& writer) {
+        writer.Write(data);
+      },
+      [] (workflow::CheckpointReader& reader, T& data) {
+        return reader.Read(data);
+      });
+}
+
+void WriteStringList(const std::vector<std::string>& list,
+                     workflow::CheckpointWriter& writer) {
+  writer.Write(static_cast<uint64_t>(list.size()));
+  for (const auto& text : list) {
+    writer.Write(text);
+  }
+}
+
+bool ReadStringList(workflow::CheckpointReader& reader,
+                    std::vector<std::string>& list) {
+  uint64_t size = 0;
+  if (!reader.Read(size)) {
+    return false;
+  }
+  list.clear();
+  for (uint64_t index = 0; index < size; ++index) {
+    std::string text;
+    if (!reader.Read(text)) {
+      return false;
+    }
+    list.emplace_back(std::move(text));
+  }
+  return true;
+}
+
+void WriteSyslog(const SyslogMessage& msg,
+                 workflow::CheckpointWriter& writer) {
+  writer.Write(static_cast<int>(msg.Severity()));
+  writer.Write(static_cast<int>(msg.Facility()));
+  writer.Write(static_cast<uint64_t>(msg.Timestamp()));
+  writer.Write(msg.Hostname());
+  writer.Write(msg.ApplicationName());
+  writer.Write(msg.ProcessId());
+  writer.Write(msg.MessageId());
+  writer.Write(msg.Message());
+}
+
+bool ReadSyslog(workflow::CheckpointReader& reader, SyslogMessage& msg) {
+  using Severity = std::remove_cvref_t<decltype(msg.Severity())>;
+  using Facility = std::remove_cvref_t<decltype(msg.Facility())>;
+  int severity = 0;
+  int facility = 0;
+  uint64_t timestamp = 0;
+  std::string hostname;
+  std::string application;
+  std::string process_id;
+  std::string message_id;
+  std::string message;
+  if (!reader.Read(severity) || !reader.Read(facility) ||
+      !reader.Read(timestamp) || !reader.Read(hostname) ||
+      !reader.Read(application) || !reader.Read(process_id) ||
+      !reader.Read(message_id) || !reader.Read(message)) {
+    return false;
+  }
+  msg.Severity(static_cast<Severity>(severity));
+  msg.Facility(static_cast<Facility>(facility));
+  msg.Timestamp(timestamp);
+  msg.Hostname(hostname);
+  msg.ApplicationName(application);
+  msg.ProcessId(process_id);
+  msg.MessageId(message_id);
+  msg.Message(message);
+  return true;
+}
+
+}
+
+namespace workflow {
+
+void CheckpointWriter::Write(const std::string& value) {
+  Write(static_cast<uint32_t>(value.size()));
+  stream_.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool CheckpointReader::Read(std::string& value) {
+  uint32_t size = 0;
+  if (!Read(size) || size > kMaxStringSize) {
+    return false;
+  }
+  value.resize(size);
+  stream_.read(value.data(), static_cast<std::streamsize>(size));
+  return stream_.good();
+}
+
+DataCheckpoint& DataCheckpoint::Instance() {
+  static DataCheckpoint instance;
+  return instance;
+}
+
+DataCheckpoint::DataCheckpoint() {
+  RegisterType<std::string>("string",
+      [] (const std::string& data, CheckpointWriter& writer) {
+        writer.Write(data);
+      },
+      [] (CheckpointReader& reader, std::string& data) {
+        return reader.Read(data);
+      });
+  RegisterType<std::vector<std::string>>("StringList", WriteStringList,
+                                         ReadStringList);
+  RegisterNumber<int>(*this, "int");
+  RegisterNumber<int64_t>(*this, "int64");
+  RegisterNumber<uint64_t>(*this, "uint64");
+  RegisterNumber<double>(*this, "double");
+  RegisterNumber<bool>(*this, "bool");
+
+  // Workflow data of the syslog tasks
+  RegisterType<SyslogMessage>("SyslogMessage", WriteSyslog, ReadSyslog);
+  RegisterType<SyslogList>("SyslogList",
+      [] (const SyslogList& data, CheckpointWriter& writer) {
+        writer.Write(static_cast<uint64_t>(data.size()));
+        for (const auto& msg : data) {
+          WriteSyslog(msg, writer);
+        }
+      },
+      [] (CheckpointReader& reader, SyslogList& data) {
+        uint64_t size = 0;
+        if (!reader.Read(size)) {
+          return false;
+        }
+        for (uint64_t index = 0; index < size; ++index) {
+          SyslogMessage msg;
+          if (!ReadSyslog(reader, msg)) {
+            return false;
+          }
+          data.emplace_back(std::move(msg));
+        }
+        return true;
+      });
+}
+
+bool DataCheckpoint::IsRegistered(const std::any& data) const {
+  std::scoped_lock lock(codec_lock_);
+  return data.has_value() &&
+         codec_list_.contains(std::type_index(data.type()));
+}
+
+bool DataCheckpoint::Save(const std::any& data, const std::string& filename,
+                          std::string& error) const {
+  if (!data.has_value()) {
+    error = "No data to save";
+    return false;
+  }
+
+  Codec codec;
+  {
+    std::scoped_lock lock(codec_lock_);
+    const auto itr = codec_list_.find(std::type_index(data.type()));
+    if (itr == codec_list_.cend()) {
+      error = "The data type is not registered";
+      return false;
+    }
+    codec = itr->second;
+  }
+
+  try {
+    // The payload is serialized first, so its size can be stored in the
+    // header. A truncated file is then detected on restore.
+    std::ostringstream payload;
+    CheckpointWriter payload_writer(payload);
+    codec.write(data, payload_writer);
+    const auto payload_data = payload.str();
+
+    const std::filesystem::path full_name(filename);
+    auto temp_name = full_name;
+    temp_name += ".tmp";
+    {
+      std::ofstream file(temp_name, std::ios::binary | std::ios::trunc);
+      if (!file.is_open()) {
+        error = "Failed to open the checkpoint file";
+        return false;
+      }
+      file.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+      CheckpointWriter writer(file);
+      writer.Write(kVersion);
+      writer.Write(codec.name);
+      writer.Write(static_cast<uint64_t>(payload_data.size()));
+      file.write(payload_data.data(),
+                 static_cast<std::streamsize>(payload_data.size()));
+      if (!writer.IsOk()) {
+        error = "Failed to write the checkpoint file";
+        return false;
+      }
+    }
+    std::filesystem::rename(temp_name, full_name);
+  } catch (const std::exception& err) {
+    std::ostringstream msg;
+    msg << "Failed to save checkpoint. Error: " << err.what();
+    error = msg.str();
+    return false;
+  }
+  return true;
+}
+
+bool DataCheckpoint::Restore(const std::string& filename, std::any& data,
+                             std::string& error) const {
+  try {
+    std::ifstream file(std::filesystem::path(filename), std::ios::binary);
+    if (!file.is_open()) {
+      error = "Failed to open the checkpoint file";
+      return false;
+    }
+    std::string magic(kMagic.size(), '\0');
+    file.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    CheckpointReader reader(file);
+    uint32_t version = 0;
+    std::string name;
+    uint64_t size = 0;
+    if (!file.good() || magic != kMagic || !reader.Read(version) ||
+        version != kVersion || !reader.Read(name) || !reader.Read(size)) {
+      error = "Invalid checkpoint header";
+      return false;
+    }
+
+    Codec codec;
+    {
+      std::scoped_lock lock(codec_lock_);
+      const auto type_itr = name_list_.find(name);
+      const auto itr = type_itr != name_list_.cend() ?
+          codec_list_.find(type_itr->second) : codec_list_.cend();
+      if (itr == codec_list_.cend()) {
+        error = "The data type is not registered. Type: " + name;
+        return false;
+      }
+      codec = itr->second;
+    }
+
+    const auto start = file.tellg();
+    std::any temp;
+    if (!codec.read(reader, temp) ||
+        static_cast<uint64_t>(file.tellg() - start) != size) {
+      error = "Invalid checkpoint data";
+      return false;
+    }
+    data = std::move(temp);
+  } catch (const std::exception& err) {
+    std::ostringstream msg;
+    msg << "Failed to restore checkpoint. Error: " << err.what();
+    error = msg.str();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace workflow
@@ -0,0 +1,109 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/derivedparameter.h"
+#include <util/logstream.h>
+#include "workflow/parametercontainer.h"
+
+namespace workflow {
+
+DerivedParameter::DerivedParameter(const ParameterContainer* container)
+: container_(container) {
+}
+
+DerivedParameter::DerivedParameter(const DerivedParameter& parameter)
+: Parameter(parameter),
+  container_(parameter.container_) {
+}
+
+bool DerivedParameter::Compile() {
+  evaluated_version_ = kNotEvaluated;
+  derived_list_.clear();
+  last_error_.clear();
+  if (container_ == nullptr) {
+    expression_.Clear();
+    last_error_ = "The parameter doesn't belong to a container.";
+    return false;
+  }
+
+  const auto resolver = [&] (const std::string& name) -> Parameter* {
+    auto* parameter = container_->GetParameter(Device(), name);
+    if (parameter == nullptr) {
+      if (const size_t dot = name.find('.'); dot != std::string::npos) {
+        parameter = container_->GetParameter(name.substr(0, dot),
+                                             name.substr(dot + 1));
+      }
+    }
+    return parameter;
+  };
+  if (!expression_.Compile(Expression(), resolver)) {
+    last_error_ = expression_.LastError();
+    return false;
+  }
+
+  for (const auto* parameter : expression_.Dependencies()) {
+    derived_list_.push_back(dynamic_cast<const DerivedParameter*>(parameter));
+  }
+  if (DependsOn(this)) {
+    expression_.Clear();
+    derived_list_.clear();
+    last_error_ = "Circular reference.";
+    return false;
+  }
+  return true;
+}
+
+uint64_t DerivedParameter::InputVersion() const {
+  // All counters only increase, so the sum only changes if an input changed.
+  uint64_t version = 0;
+  for (const auto* parameter : expression_.Dependencies()) {
+    version += parameter->InputVersion();
+  }
+  return version;
+}
+
+bool DerivedParameter::DependsOn(const DerivedParameter* parameter) const {
+  for (const auto* derived : derived_list_) {
+    if (derived == nullptr) {
+      continue;
+    }
+    if (derived == parameter || derived->DependsOn(parameter)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DerivedParameter::Init() {
+  // Not Parameter::Init(), as it reports the value as a change
+  CacheValue(false, 0.0);
+  if (!Compile()) {
+    LOG_ERROR() << "Invalid formula. Parameter: " << Name()
+                << ", Error: " << last_error_;
+  }
+}
+
+void DerivedParameter::OnGetValue() {
+  if (!expression_.IsOk()) {
+    return;
+  }
+  const uint64_t version = InputVersion();
+  if (version == evaluated_version_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::scoped_lock lock(evaluate_lock_);
+  if (version == evaluated_version_.load(std::memory_order_acquire)) {
+    return; // Calculated by another thread
+  }
+  // An input that changes during the calculation gives a new version, so
+  // the next read calculates the value again.
+  double value = 0.0;
+  const bool valid = expression_.Evaluate(value);
+  CacheValue(valid, value);
+  ++nof_evaluations_;
+  evaluated_version_.store(version, std::memory_order_release);
+}
+
+}  // namespace workflow
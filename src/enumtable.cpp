@@ -0,0 +1,128 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/enumtable.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+using TableList = std::vector<std::weak_ptr<const workflow::EnumTable>>;
+
+std::mutex intern_lock;
+/// Interned tables sorted on the hash of their definition.
+std::unordered_map<size_t, TableList> intern_list;
+/// Number of buckets that triggers a removal of unused buckets.
+size_t sweep_size = 16;
+
+size_t HashEnumList(const workflow::EnumList& enum_list) {
+  size_t hash = enum_list.size();
+  for (const auto& [value, name] : enum_list) {
+    hash = hash * 31 + std::hash<int64_t>{}(value);
+    hash = hash * 31 + std::hash<std::string>{}(name);
+  }
+  return hash;
+}
+
+}
+
+namespace workflow {
+
+EnumTable::EnumTable(EnumList enum_list)
+: enum_list_(std::move(enum_list)) {
+  value_index_.reserve(enum_list_.size());
+  for (const auto& [value, name] : enum_list_) {
+    // The first value wins if a name is used twice
+    value_index_.emplace(name, value);
+  }
+  if (enum_list_.empty()) {
+    return;
+  }
+
+  // Enumerates are normally numbered 0..N, so an array is used if it
+  // isn't much larger than the number of values.
+  first_value_ = enum_list_.cbegin()->first;
+  const int64_t last_value = enum_list_.crbegin()->first;
+  const auto range = static_cast<uint64_t>(last_value) -
+                     static_cast<uint64_t>(first_value_);
+  if (range < 2 * enum_list_.size() + 16) {
+    name_array_.resize(range + 1, nullptr);
+    for (const auto& [value, name] : enum_list_) {
+      name_array_[static_cast<uint64_t>(value) -
+                  static_cast<uint64_t>(first_value_)] = &name;
+    }
+  } else {
+    name_index_.reserve(enum_list_.size());
+    for (const auto& [value, name] : enum_list_) {
+      name_index_.emplace(value, &name);
+    }
+  }
+}
+
+std::shared_ptr<const EnumTable> EnumTable::Intern(const EnumList& enum_list) {
+  if (enum_list.empty()) {
+    return {};
+  }
+  const size_t hash = HashEnumList(enum_list);
+  std::scoped_lock lock(intern_lock);
+  // Tables that are no longer used leave their buckets behind. They are
+  // removed each time the map has doubled, so enumerates that come and go
+  // don't grow the map without bound.
+  if (intern_list.size() >= sweep_size) {
+    std::erase_if(intern_list, [] (const auto& bucket) {
+      return std::ranges::all_of(bucket.second, [] (const auto& table) {
+        return table.expired();
+      });
+    });
+    sweep_size = std::max<size_t>(16, 2 * intern_list.size());
+  }
+  auto& table_list = intern_list[hash];
+  std::erase_if(table_list, [] (const auto& table) {
+    return table.expired();
+  });
+  for (const auto& weak_table : table_list) {
+    auto table = weak_table.lock();
+    if (table && table->List() == enum_list) {
+      return table;
+    }
+  }
+  auto table = std::make_shared<const EnumTable>(enum_list);
+  table_list.emplace_back(table);
+  return table;
+}
+
+size_t EnumTable::NofInterned() {
+  std::scoped_lock lock(intern_lock);
+  size_t count = 0;
+  for (const auto& [hash, table_list] : intern_list) {
+    for (const auto& table : table_list) {
+      if (!table.expired()) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+const std::string* EnumTable::Name(int64_t value) const {
+  if (!name_array_.empty()) {
+    const auto index = static_cast<uint64_t>(value) -
+                       static_cast<uint64_t>(first_value_);
+    return index < name_array_.size() ? name_array_[index] : nullptr;
+  }
+  const auto itr = name_index_.find(value);
+  return itr != name_index_.cend() ? itr->second : nullptr;
+}
+
+bool EnumTable::Value(std::string_view name, int64_t& value) const {
+  const auto itr = value_index_.find(name);
+  if (itr == value_index_.cend()) {
+    return false;
+  }
+  value = itr->second;
+  return true;
+}
+
+}  // namespace workflow
@@ -6,6 +6,7 @@
 #include "workflow/event.h"
 #include <util/stringutil.h>
 #include "workflow/workflow.h"
+#include "workflow/workflowqueue.h"
 #include <chrono>
 #include <util/timestamp.h>
 
@@ -16,10 +17,7 @@ using namespace util::time;
 namespace workflow {
 
 Event::~Event() {
-  stop_thread_ = true;
-  if (working_thread_.joinable()) {
-    working_thread_.join();
-  }
+  StopThread();
 }
 
 Event::Event(const Event& event)
@@ -44,7 +42,7 @@ bool Event::operator==(const Event& event) const {
 void Event::EventTypeAsString(const std::string& type) {
   Event temp;
   for (auto index = static_cast<int>(EventType::Init);
-       index <= static_cast<int>(EventType::Parameter);
+       index <= static_cast<int>(EventType::Queue);
        ++index) {
     temp.Type(static_cast<EventType>(index));
     const auto type_string = temp.EventTypeAsString();
@@ -72,6 +70,9 @@ std::string Event::EventTypeAsString() const {
     case EventType::Parameter:
       return "Parameter";
 
+    case EventType::Queue:
+      return "Queue Event";
+
     default:
       break;
   }
@@ -144,6 +145,14 @@ void Event::Init() {
       break;
     }
 
+    case EventType::Queue:
+      StopThread();
+      if (queue_ != nullptr) {
+        stop_thread_ = false;
+        working_thread_ = std::thread(&Event::QueueTask, this);
+      }
+      break;
+
     case EventType::Exit:
     default:
       break;
@@ -184,10 +193,8 @@ void Event::Exit() {
 
     case EventType::Periodic:
     case EventType::Cyclic:
-      stop_thread_ = true;
-      if (working_thread_.joinable()) {
-        working_thread_.join();
-      }
+    case EventType::Queue:
+      StopThread();
       break;
 
     default:
@@ -213,6 +220,28 @@ void Event::CyclicTask() {
   }
 }
 
+void Event::QueueTask() {
+  // The workflow is only ticked on new pushes. A workflow that doesn't pop,
+  // for example due to an open circuit breaker, is not ticked in a loop.
+  uint64_t signal = 0;
+  while (!stop_thread_) {
+    if (queue_->WaitForItems(stop_thread_, signal) && !stop_thread_) {
+      Tick();
+    }
+  }
+}
+
+void Event::StopThread() {
+  stop_thread_ = true;
+  if (!working_thread_.joinable()) {
+    return;
+  }
+  if (queue_ != nullptr) {
+    queue_->Wake();
+  }
+  working_thread_.join();
+}
+
 void Event::PeriodicTask() {
   while (!stop_thread_) {
     const auto now = std::chrono::system_clock::now();
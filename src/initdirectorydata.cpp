@@ -35,9 +35,22 @@ InitDirectoryData::InitDirectoryData(const ITask& source)
   ParseArguments();
 }
 
+std::unique_ptr<ITask> InitDirectoryData::Clone() const {
+  return std::make_unique<InitDirectoryData>(*this);
+}
+
 void InitDirectoryData::Init() {
   ITask::Init();
   ParseArguments();
+
+  // Directory data that the workflow restored, may have been saved with
+  // other arguments.
+  auto* workflow = GetWorkflow();
+  auto* data = workflow != nullptr ? workflow->GetData<IDirectory>() : nullptr;
+  if (data != nullptr) {
+    ApplyArguments(*data);
+    workflow->DataChanged();
+  }
 }
 
 void InitDirectoryData::Tick() {
@@ -57,9 +70,7 @@ void InitDirectoryData::Tick() {
       // The initializing of directory is placed here instead of in the Init()
       // due to network error
       IDirectory dir;
-      dir.Directory(root_dir_);
-      dir.StringToIncludeList(include_filter_);
-      dir.StringToExcludeList(exclude_filter_);
+      ApplyArguments(dir);
       const auto create = workflow->InitData<IDirectory>(dir);
       if (!create) {
         LastError("Failed to init the directory data");
@@ -78,6 +89,12 @@ void InitDirectoryData::Tick() {
 
 }
 
+void InitDirectoryData::ApplyArguments(IDirectory& dir) const {
+  dir.Directory(root_dir_);
+  dir.StringToIncludeList(include_filter_);
+  dir.StringToExcludeList(exclude_filter_);
+}
+
 void InitDirectoryData::ParseArguments() {
   try {
     options_description desc("Available Arguments");
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <util/idirectory.h>
 #include "workflow/itask.h"
 
 namespace workflow {
@@ -14,6 +15,7 @@ class InitDirectoryData : public ITask {
  public:
   InitDirectoryData();
   explicit InitDirectoryData(const ITask& source);
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override;
   void Init() override;
   void Tick() override;
  private:
@@ -22,6 +24,7 @@ class InitDirectoryData : public ITask {
   std::string exclude_filter_;
 
   void ParseArguments();
+  void ApplyArguments(util::log::IDirectory& dir) const;
 };
 
 }  // namespace workflow
@@ -6,6 +6,8 @@
 #include "workflow/itask.h"
 #include <util/stringutil.h>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 #include "workflow/workflow.h"
 
 using namespace util::xml;
@@ -20,7 +22,14 @@ ITask::ITask(const ITask& source)
   type_(source.type_),
   template_(source.template_),
   period_(source.period_),
-  parameter_list_(source.parameter_list_) {
+  parameter_list_(source.parameter_list_),
+  breaker_(source.breaker_),
+  reads_data_(source.reads_data_),
+  timeout_(source.timeout_) {
+}
+
+std::unique_ptr<ITask> ITask::Clone() const {
+  return std::make_unique<ITask>(*this);
 }
 
 bool ITask::operator==(const ITask& runner) const {
@@ -31,6 +40,9 @@ bool ITask::operator==(const ITask& runner) const {
   if (type_ != runner.type_) return false;
   if (template_ != runner.template_) return false;
   if (period_ != runner.period_) return false;
+  if (!(breaker_ == runner.breaker_)) return false;
+  if (reads_data_ != runner.reads_data_) return false;
+  if (timeout_ != runner.timeout_) return false;
   const auto list_equal =
       std::ranges::equal(parameter_list_,runner.parameter_list_,
       [] (const auto* parameter1, const auto* parameter2) {
@@ -95,6 +107,9 @@ void ITask::SaveXml(IXmlNode& root) const {
   runner_root.SetProperty("Type", TypeAsString());
   runner_root.SetProperty("Template", template_);
   runner_root.SetProperty("Period", period_);
+  runner_root.SetProperty("ReadsData", reads_data_);
+  runner_root.SetProperty("Timeout", timeout_);
+  breaker_.SaveXml(runner_root);
 }
 
 void ITask::ReadXml(const IXmlNode& root) {
@@ -105,10 +120,32 @@ void ITask::ReadXml(const IXmlNode& root) {
   TypeAsString(root.Property<std::string>("Type"));
   template_ = root.Property<std::string>("Template");
   period_ = root.Property<double>("Period");
+  reads_data_ = root.Property<bool>("ReadsData", false);
+  timeout_ = root.Property<double>("Timeout", 0.0);
+  breaker_.ReadXml(root);
 }
 
 void ITask::AttachWorkflow(Workflow* workflow) {
   workflow_ = workflow;
+  last_input_version_ = kNoInputVersion;
+}
+
+bool ITask::HasInputs() const {
+  return reads_data_ || !parameter_list_.empty();
+}
+
+uint64_t ITask::InputVersion() const {
+  // All counters only increase, so the sum only changes if an input changed.
+  uint64_t version = 0;
+  for (const auto* parameter : parameter_list_) {
+    if (parameter != nullptr) {
+      version += parameter->InputVersion();
+    }
+  }
+  if (reads_data_ && workflow_ != nullptr) {
+    version += workflow_->DataVersion();
+  }
+  return version;
 }
 
 const ITask* ITask::GetTaskByTemplateName(const std::string& name) const {
@@ -116,4 +153,43 @@ const ITask* ITask::GetTaskByTemplateName(const std::string& name) const {
     nullptr;
 }
 
+uint64_t ITask::SteadyTime() {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+void ITask::TickStarted(uint64_t now) {
+  tick_thread_ = std::hash<std::thread::id>{}(std::this_thread::get_id());
+  tick_start_ = now;
+}
+
+void ITask::TickStopped(uint64_t now) {
+  const auto start = tick_start_.exchange(0);
+  if (stalled_ && start > 0 && now > start) {
+    // Report the total time of the stalled tick
+    stall_duration_ = now - start;
+  }
+  stalled_ = false;
+}
+
+bool ITask::CheckTimeout(uint64_t now) {
+  const auto start = tick_start_.load();
+  if (timeout_ <= 0.0 || start == 0 || now <= start) {
+    return false;
+  }
+  const auto duration = now - start;
+  if (static_cast<double>(duration) < timeout_ * 1'000'000'000.0) {
+    return false;
+  }
+  stall_duration_ = duration;
+  const bool was_stalled = stalled_.exchange(true);
+  if (tick_start_ != start) {
+    // The tick stopped while checking
+    stalled_ = false;
+    return false;
+  }
+  return !was_stalled;
+}
+
 }  // namespace workflow
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/nameindex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+char FoldChar(char character) {
+  return static_cast<char>(
+      std::tolower(static_cast<unsigned char>(character)));
+}
+
+}  // namespace
+
+namespace workflow {
+
+std::atomic<uint64_t> NameIndex::name_generation_ = 1;
+
+NameIndex::NameIndex(const NameIndex& index)
+    : index_list_(index.index_list_),
+      generation_(index.generation_.load()) {
+}
+
+NameIndex& NameIndex::operator=(const NameIndex& index) {
+  if (this != &index) {
+    index_list_ = index.index_list_;
+    generation_ = index.generation_.load();
+  }
+  return *this;
+}
+
+void NameIndex::Clear() {
+  index_list_.clear();
+  generation_ = name_generation_.load();
+}
+
+size_t NameIndex::FoldHash::operator()(std::string_view name) const {
+  // FNV-1a of the lower case characters
+  uint64_t hash = 14'695'981'039'346'656'037ULL;
+  for (const char character : name) {
+    hash ^= static_cast<unsigned char>(FoldChar(character));
+    hash *= 1'099'511'628'211ULL;
+  }
+  return static_cast<size_t>(hash);
+}
+
+bool NameIndex::FoldEqual::operator()(std::string_view name1,
+                                      std::string_view name2) const {
+  return std::ranges::equal(name1, name2, [] (char char1, char char2) {
+    return FoldChar(char1) == FoldChar(char2);
+  });
+}
+
+void NameIndex::Add(std::string_view name, size_t index) {
+  index_list_.emplace(std::string(name), index);
+}
+
+size_t NameIndex::Find(std::string_view name) const {
+  if (index_list_.empty()) {
+    return kNotFound;
+  }
+  const auto itr = index_list_.find(name);
+  return itr != index_list_.cend() ? itr->second : kNotFound;
+}
+
+std::string NameIndex::Fold(std::string_view name) {
+  std::string folded(name);
+  std::ranges::transform(folded, folded.begin(), FoldChar);
+  return folded;
+}
+
+}  // namespace workflow
@@ -4,391 +4,449 @@
  */
 
 #include "workflow/parameter.h"
-#include <ranges>
+#include "workflow/changenotifier.h"
 #include <algorithm>
 #include <cstring>
+#include <string_view>
+#include <chrono>
+#include <thread>
 #include <util/stringutil.h>
 #include <util/ixmlnode.h>
 using namespace util::xml;
 
+namespace {
+
+bool TextAsBool(std::string_view text) {
+  if (text.empty()) {
+    return false;
+  }
+  switch (text[0]) {
+    case 'T':  // "True"
+    case 't':  // "true"
+    case 'Y':  // "Yes"
+    case 'y':  // "yes"
+    case 'E':  // "Enabled"
+    case 'e':  // "enabled"
+    case '1':  // "1"
+      return true;
+
+    case 'O':  // "ON"
+    case 'o':  // "on"
+      return text.size() > 1 && (text[1] == 'N' || text[1] == 'n');
+
+    default:
+      break;
+  }
+  return false;
+}
+
+uint64_t MonotonicTime() {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+}
+
 namespace workflow {
 
 
 Parameter::Parameter(const Parameter& parameter)
 : name_(parameter.name_),
-  unit_(parameter.unit_),
-  description_(parameter.description_),
-  device_(parameter.device_),
-  signal_(parameter.signal_),
-  identity_(parameter.identity_),
-  display_name_(parameter.display_name_),
-  data_type_(parameter.data_type_),
-  enum_list_(parameter.enum_list_)
-{
+  device_(parameter.device_) {
+  DataType(parameter.data_type_);
+  if (parameter.info_) {
+    info_ = std::make_unique<ParameterInfo>(*parameter.info_);
+  }
+  HistorySize(parameter.HistorySize());
+  if (parameter.deadband_) {
+    Deadband(parameter.deadband_->absolute, parameter.deadband_->relative,
+             parameter.deadband_->hysteresis);
+  }
 }
 
 bool Parameter::operator==(const Parameter& parameter) const {
   if (name_ != parameter.name_) return false;
-  if (unit_ != parameter.unit_) return false;
-  if (description_ != parameter.description_) return false;
   if (device_ != parameter.device_) return false;
-  if (signal_ != parameter.signal_) return false;
-  if (identity_ != parameter.identity_) return false;
-  if (display_name_ != parameter.display_name_) return false;
   if (data_type_ != parameter.data_type_) return false;
-  if (enum_list_ != parameter.enum_list_) return false;
-  return true;
+  if (HistorySize() != parameter.HistorySize()) return false;
+  const ParameterDeadband no_deadband;
+  const auto& deadband = deadband_ ? *deadband_ : no_deadband;
+  const auto& other = parameter.deadband_ ? *parameter.deadband_ : no_deadband;
+  if (deadband.absolute != other.absolute) return false;
+  if (deadband.relative != other.relative) return false;
+  if (deadband.hysteresis != other.hysteresis) return false;
+  if (info_ && parameter.info_) {
+    return *info_ == *parameter.info_;
+  }
+  // A missing info is equal to an empty info
+  const ParameterInfo empty;
+  return *(info_ ? info_.get() : &empty) ==
+         *(parameter.info_ ? parameter.info_.get() : &empty);
+}
+
+void Parameter::DataType(ParameterDataType type) {
+  data_type_ = type;
+  switch (type) {
+    case ParameterDataType::StringType:
+    case ParameterDataType::ByteArrayType:
+      if (!buffer_) {
+        buffer_ = std::make_unique<std::atomic<SharedBuffer>>();
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+ParameterInfo& Parameter::Info() {
+  if (!info_) {
+    info_ = std::make_unique<ParameterInfo>();
+  }
+  return *info_;
 }
 
 template <>
 bool Parameter::GetValue(bool& value) {
   OnGetValue();
-  std::scoped_lock lock(value_lock_);
+  uint64_t bits = 0;
+  bool valid = false;
   switch (DataType()) {
     case ParameterDataType::BooleanType:
     case ParameterDataType::UnsignedType:
-      value = value_uint_ > 0;
+      valid = LoadValue(bits);
+      value = bits > 0;
       break;
 
     case ParameterDataType::SignedType:
-      value = value_int_ > 0;
+      valid = LoadValue(bits);
+      value = std::bit_cast<int64_t>(bits) > 0;
       break;
 
     case ParameterDataType::FloatType:
-      value = value_float_ > 0.5;
+      valid = LoadValue(bits);
+      value = std::bit_cast<double>(bits) > 0.5;
       break;
 
-    case ParameterDataType::StringType:
-      value = false;
-      if (!value_text_.empty()) {
-        switch (value_text_[0]) {
-          case 'T':  // "True"
-          case 't':  // "true"
-          case 'Y':  // "Yes"
-          case 'y':  // "yes"
-          case '1':  // "1"
-            value = true;
-            break;
-
-          case 'O':  // "ON"
-          case 'o':  // "on"
-            value = value_text_.size() > 1 &&
-                    (value_text_[1] == 'N' || value_text_[1] == 'n');
-            break;
-
-          case 'E':  // "Enabled"
-          case 'e':  // "enabled"
-            value = true;
-            break;
-
-          default:
-            break;
-        }
-      }
+    case ParameterDataType::StringType: {
+      SharedBuffer text;
+      valid = LoadBuffer(text);
+      value = text && TextAsBool(std::string_view(
+                          reinterpret_cast<const char*>(text->data()),
+                          text->size()));
       break;
+    }
 
     case ParameterDataType::EnumType: {
-      const auto itr = enum_list_.find(value_int_);
-      if (itr == enum_list_.cend()) {
-        break;
-      }
-      const auto& temp = itr->second;
-      if (!temp.empty()) {
-        switch (temp[0]) {
-          case 'T':  // "True"
-          case 't':  // "true"
-          case 'Y':  // "Yes"
-          case 'y':  // "yes"
-          case '1':  // "1"
-            value = true;
-            break;
-
-          case 'O':  // "ON"
-          case 'o':  // "on"
-            value = temp.size() > 1 && (temp[1] == 'N' || temp[1] == 'n');
-            break;
-
-          case 'E':  // "Enabled"
-          case 'e':  // "enabled"
-            value = true;
-            break;
-
-          default:
-            break;
-        }
+      valid = LoadValue(bits);
+      const auto* name = EnumName(bits);
+      if (name != nullptr) {
+        value = TextAsBool(*name);
       }
       break;
     }
 
     case ParameterDataType::ByteArrayType:
     default:
+      valid = Valid();
       break;
   }
-  return valid_;
+  return valid;
 }
 
 template <>
 bool Parameter::GetValue(std::string& value) {
   OnGetValue();
-  std::scoped_lock lock(value_lock_);
+  uint64_t bits = 0;
+  bool valid = false;
   switch (DataType()) {
     case ParameterDataType::BooleanType:
-      value = value_uint_ ? "1" : "0";
+      valid = LoadValue(bits);
+      value = bits ? "1" : "0";
       break;
 
-
-    case ParameterDataType::SignedType:
-      value = std::to_string(value_int_);
+    case ParameterDataType::SignedType: {
+      valid = LoadValue(bits);
+      NumberBuffer buffer;
+      value = FormatNumber(std::bit_cast<int64_t>(bits), buffer);
       break;
+    }
 
-    case ParameterDataType::UnsignedType:
-      value = std::to_string(value_uint_);
+    case ParameterDataType::UnsignedType: {
+      valid = LoadValue(bits);
+      NumberBuffer buffer;
+      value = FormatNumber(bits, buffer);
       break;
+    }
 
     case ParameterDataType::FloatType: {
-      std::ostringstream temp;
-      temp << value_float_;
-      value = temp.str();
+      valid = LoadValue(bits);
+      NumberBuffer buffer;
+      value = FormatNumber(std::bit_cast<double>(bits), buffer);
       break;
     }
 
-    case ParameterDataType::StringType:
-      value = value_text_;
+    case ParameterDataType::StringType: {
+      SharedBuffer text;
+      valid = LoadBuffer(text);
+      if (text) {
+        value.assign(text->cbegin(), text->cend());
+      } else {
+        value.clear();
+      }
       break;
+    }
 
     case ParameterDataType::EnumType: {
-      const auto itr = enum_list_.find(value_int_);
-      if (itr != enum_list_.cend()) {
-        value = itr->second;
+      valid = LoadValue(bits);
+      const auto* name = EnumName(bits);
+      if (name != nullptr) {
+        value = *name;
       }
       break;
     }
 
     case ParameterDataType::ByteArrayType: {
-      const std::string text(reinterpret_cast<const char*>(
-                               value_array_.data()),
-                               value_array_.size());
-      value = text;
+      SharedBuffer array;
+      valid = LoadBuffer(array);
+      if (array) {
+        value.assign(array->cbegin(), array->cend());
+      } else {
+        value.clear();
+      }
       break;
     }
 
     default:
-     break;
+      valid = Valid();
+      break;
   }
-  return valid_;
+  return valid;
 }
 
 template <>
 bool Parameter::GetValue(ByteArray& value) {
   OnGetValue();
-  std::scoped_lock lock(value_lock_);
-
+  uint64_t bits = 0;
+  bool valid = false;
   switch (DataType()) {
     case ParameterDataType::BooleanType:
+      valid = LoadValue(bits);
       value.resize(1);
-      value[0] = value_uint_ > 0 ? 1 : 0;
+      value[0] = bits > 0 ? 1 : 0;
       break;
 
     case ParameterDataType::SignedType:
-      value.resize(sizeof(value_int_));
-      memcpy(value.data(), &value_int_, value.size());
-      break;
-
     case ParameterDataType::UnsignedType:
-      value.resize(sizeof(value_uint_));
-      memcpy(value.data(), &value_uint_, value.size());
-      break;
-
     case ParameterDataType::FloatType:
-      value.resize(sizeof(value_float_));
-      memcpy(value.data(), &value_float_, value.size());
+      // The 64-bit pattern is the memory layout of the value.
+      valid = LoadValue(bits);
+      value.resize(sizeof(bits));
+      memcpy(value.data(), &bits, value.size());
       break;
 
-    case ParameterDataType::StringType:
-      value.resize(value_array_.size());
-      memcpy(value.data(), value_array_.data(), value.size());
+    case ParameterDataType::StringType: {
+      SharedBuffer text;
+      valid = LoadBuffer(text);
+      if (text) {
+        value = *text;
+      } else {
+        value.clear();
+      }
       break;
+    }
 
     case ParameterDataType::EnumType: {
-      const auto itr = enum_list_.find(value_int_);
-      if (itr != enum_list_.cend()) {
-        value.resize(itr->second.size());
-        memcpy(value.data(), itr->second.data(), value.size());
+      valid = LoadValue(bits);
+      const auto* name = EnumName(bits);
+      if (name != nullptr) {
+        value.assign(name->cbegin(), name->cend());
+      } else {
+        value.clear();
+      }
+      break;
+    }
+
+    case ParameterDataType::ByteArrayType: {
+      SharedBuffer array;
+      valid = LoadBuffer(array);
+      if (array) {
+        value = *array;
       } else {
         value.clear();
-     }
-     break;
+      }
+      break;
     }
 
-    case ParameterDataType::ByteArrayType:
-      value = value_array_;
+    default:
+      valid = Valid();
       break;
+  }
+  return valid;
+}
 
+template <>
+bool Parameter::GetValue(SharedBuffer& value) {
+  switch (DataType()) {
+    case ParameterDataType::StringType:
+    case ParameterDataType::ByteArrayType: {
+      OnGetValue();
+      const bool valid = LoadBuffer(value);
+      if (!value) {
+        value = std::make_shared<const ByteArray>();
+      }
+      return valid;
+    }
 
     default:
       break;
   }
-  return valid_;
+  ByteArray array;
+  const bool valid = GetValue(array);
+  value = std::make_shared<const ByteArray>(std::move(array));
+  return valid;
 }
 
 template <>
 void Parameter::SetValue(bool valid, const bool& value) {
-  {
-    std::scoped_lock lock(value_lock_);
-    valid_ = valid;
-
-    switch (data_type_) {
-      case ParameterDataType::BooleanType:
-      case ParameterDataType::UnsignedType:value_uint_ = value ? 1 : 0;
-        break;
-
-      case ParameterDataType::EnumType:
-      case ParameterDataType::SignedType:value_int_ = value ? 1 : 0;
-        break;
+  switch (data_type_) {
+    case ParameterDataType::BooleanType:
+    case ParameterDataType::UnsignedType:
+    case ParameterDataType::EnumType:
+    case ParameterDataType::SignedType:
+      StoreValue(valid, value ? 1 : 0);
+      break;
 
-      case ParameterDataType::FloatType:value_float_ = value ? 1.0 : 0.0;
-        break;
+    case ParameterDataType::FloatType:
+      StoreValue(valid, std::bit_cast<uint64_t>(value ? 1.0 : 0.0));
+      break;
 
-      case ParameterDataType::StringType:value_text_ = value ? "1" : "0";
-        break;
+    case ParameterDataType::StringType:
+      StoreBuffer(valid, ByteArray(1, value ? '1' : '0'));
+      break;
 
-      case ParameterDataType::ByteArrayType:value_array_.resize(1);
-        value_array_[0] = value ? 1 : 0;
-        break;
+    case ParameterDataType::ByteArrayType:
+      StoreBuffer(valid, ByteArray(1, value ? 1 : 0));
+      break;
 
-      default:break;
-    }
+    default:
+      Valid(valid);
+      break;
   }
   OnSetValue();
 }
 
 template <>
 void Parameter::SetValue(bool valid, const std::string& value) {
-  {
-    std::scoped_lock lock(value_lock_);
-    valid_ = valid;
-
-    switch (data_type_) {
-      case ParameterDataType::BooleanType: {
-        if (value.empty()) {
-          value_uint_ = 0;
-        } else {
-          switch (value[0]) {
-            case 'T': // True
-            case 't':
-            case 'Y': // Yes
-            case 'y':
-            case 'E': // "Enabled"
-            case 'e':
-            case '1':value_uint_ = 1;
-              break;
-            case 'O': // ON
-            case 'o':
-              if (value.size() > 1 && value[1] == 'N' || value[1] == 'n') {
-                value_uint_ = 1;
-              } else {
-                value_uint_ = 0;
-              }
-              break;
-
-            default:value_uint_ = 0;
-              break;
-          }
-
-        }
-        break;
+  switch (data_type_) {
+    case ParameterDataType::BooleanType:
+      StoreValue(valid, TextAsBool(value) ? 1 : 0);
+      break;
+
+    case ParameterDataType::UnsignedType: {
+      uint64_t number = 0;
+      if (ParseNumber(value, number)) {
+        StoreValue(valid, number);
+      } else {
+        Valid(valid);
       }
+      break;
+    }
 
-      case ParameterDataType::UnsignedType:
-        try {
-          value_uint_ = std::stoull(value);
-        } catch (const std::exception &) {}
-        break;
-
-      case ParameterDataType::EnumType:
-        try {
-          const auto itr = std::ranges::find_if(enum_list_,
-                                                [&](const auto &enum_itr) {
-                                                  return enum_itr.second == value;
-                                                });
-          if (itr != enum_list_.cend()) {
-            value_int_ = itr->first;
-          } else {
-            value_int_ = std::stoll(value);
-          }
-        } catch (const std::exception &) {}
-        break;
-
-      case ParameterDataType::SignedType:
-        try {
-          value_int_ = std::stoll(value);
-        } catch (const std::exception &) {}
-        break;
-
-      case ParameterDataType::FloatType:
-        try {
-          value_float_ = std::stod(value);
-        } catch (const std::exception &) {}
-        break;
-
-      case ParameterDataType::StringType:value_text_ = value;
-        break;
-
-      case ParameterDataType::ByteArrayType:value_array_.resize(value.size());
-        memcpy(value_array_.data(),
-               reinterpret_cast<const uint8_t *>(value.data()),
-               value.size());
-        break;
-
-      default:break;
+    case ParameterDataType::EnumType: {
+      const auto* enum_table = GetEnumTable();
+      int64_t id = 0;
+      if (enum_table != nullptr && enum_table->Value(value, id)) {
+        StoreValue(valid, std::bit_cast<uint64_t>(id));
+      } else if (ParseNumber(value, id)) {
+        StoreValue(valid, std::bit_cast<uint64_t>(id));
+      } else {
+        Valid(valid);
+      }
+      break;
     }
+
+    case ParameterDataType::SignedType: {
+      int64_t number = 0;
+      if (ParseNumber(value, number)) {
+        StoreValue(valid, std::bit_cast<uint64_t>(number));
+      } else {
+        Valid(valid);
+      }
+      break;
+    }
+
+    case ParameterDataType::FloatType: {
+      double number = 0.0;
+      if (ParseNumber(value, number)) {
+        StoreValue(valid, std::bit_cast<uint64_t>(number));
+      } else {
+        Valid(valid);
+      }
+      break;
+    }
+
+    case ParameterDataType::StringType:
+      StoreBuffer(valid, ByteArray(value.cbegin(), value.cend()));
+      break;
+
+    case ParameterDataType::ByteArrayType:
+      StoreBuffer(valid, ByteArray(value.cbegin(), value.cend()));
+      break;
+
+    default:
+      Valid(valid);
+      break;
   }
   OnSetValue();
 }
 
 template <>
 void Parameter::SetValue(bool valid, const ByteArray& value) {
-  {
-    std::scoped_lock lock(value_lock_);
-    valid_ = valid;
-
-    switch (data_type_) {
-      case ParameterDataType::UnsignedType:
-      case ParameterDataType::BooleanType:
-        if (value.empty()) {
-          value_uint_ = 0;
-        } else {
-          value_uint_ = value[0];
-        }
-        break;
-
-      case ParameterDataType::EnumType:
-      case ParameterDataType::SignedType:
-        if (value.empty()) {
-          value_int_ = 0;
-        } else {
-          value_int_ = value[0];
-        }
-        break;
-
-      case ParameterDataType::FloatType:
-        if (value.empty()) {
-          value_float_ = 0;
-        } else {
-          value_float_ = value[0];
-        }
-        break;
-
-      case ParameterDataType::StringType:value_text_.resize(value.size());
-        memcpy(value_text_.data(), reinterpret_cast<const char *>(value.data()),
-               value.size());
-        break;
-
-      case ParameterDataType::ByteArrayType:value_array_ = value;
-        break;
-
-      default:break;
-    }
+  SetValue(valid, ByteSpan(value));
+}
+
+template <>
+void Parameter::SetValue(bool valid, const SharedBuffer& value) {
+  switch (data_type_) {
+    case ParameterDataType::StringType:
+    case ParameterDataType::ByteArrayType:
+      StoreBuffer(valid, value ? value
+                               : std::make_shared<const ByteArray>());
+      OnSetValue();
+      break;
+
+    default:
+      SetValue(valid, value ? ByteSpan(*value) : ByteSpan());
+      break;
+  }
+}
+
+template <>
+void Parameter::SetValue(bool valid, const ByteSpan& value) {
+  const uint64_t first = value.empty() ? 0 : value[0];
+  switch (data_type_) {
+    case ParameterDataType::UnsignedType:
+    case ParameterDataType::BooleanType:
+    case ParameterDataType::EnumType:
+    case ParameterDataType::SignedType:
+      StoreValue(valid, first);
+      break;
+
+    case ParameterDataType::FloatType:
+      StoreValue(valid, std::bit_cast<uint64_t>(static_cast<double>(first)));
+      break;
+
+    case ParameterDataType::StringType:
+    case ParameterDataType::ByteArrayType:
+      StoreBuffer(valid, BufferPool::Default().Copy(value.data(),
+                                                    value.size()));
+      break;
+
+    default:
+      Valid(valid);
+      break;
   }
   OnSetValue();
 }
@@ -437,13 +495,235 @@ std::string Parameter::DataTypeAsString() const {
 }
 
 void Parameter::Valid(bool valid) {
-  std::scoped_lock lock(value_lock_);
-  valid_ = valid;
+  EndWrite(BeginWrite(), valid);
 }
 
 bool Parameter::Valid() const {
-  std::scoped_lock lock(value_lock_);
-  return valid_;
+  return (StateWord().load(std::memory_order_acquire) &
+          ValueSlot::kValidBit) != 0;
+}
+
+uint64_t Parameter::BeginWrite() {
+  // Writers are serialized by the write bit. Readers never block a writer.
+  auto& state_word = StateWord();
+  uint64_t state = state_word.load(std::memory_order_relaxed);
+  while (true) {
+    if ((state & ValueSlot::kWriteBit) != 0) {
+      std::this_thread::yield();
+      state = state_word.load(std::memory_order_relaxed);
+    } else if (state_word.compare_exchange_weak(state,
+                                                state | ValueSlot::kWriteBit,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+      std::atomic_thread_fence(std::memory_order_release);
+      return state;
+    }
+  }
+}
+
+void Parameter::EndWrite(uint64_t state, bool valid, bool report) {
+  uint64_t next = (state & ~(ValueSlot::kValidBit | ValueSlot::kWriteBit)) +
+                  ValueSlot::kVersionStep;
+  if (valid) {
+    next |= ValueSlot::kValidBit;
+  }
+  if (!report) {
+    StateWord().store(next, std::memory_order_release);
+    return;
+  }
+  const uint64_t timestamp = MonotonicTime();
+  slot_.timestamp.store(timestamp, std::memory_order_release);
+  if (store_ != nullptr) {
+    store_->Stamp(store_index_, timestamp);
+  }
+  if (history_) {
+    // The write bit makes this thread the only history writer
+    history_->Add(timestamp, valid,
+                  ValueAsDouble(ValueWord().load(std::memory_order_relaxed)));
+  }
+  StateWord().store(next, std::memory_order_release);
+  if (notifier_ != nullptr && notifier_->Active()) {
+    notifier_->Changed(*this);
+  }
+}
+
+bool Parameter::LoadBuffer(SharedBuffer& buffer) const {
+  if (!buffer_) {
+    buffer.reset();
+    return Valid();
+  }
+  const auto& state_word = StateWord();
+  while (true) {
+    const uint64_t state = state_word.load(std::memory_order_acquire);
+    if ((state & ValueSlot::kWriteBit) == 0) {
+      buffer = buffer_->load(std::memory_order_acquire);
+      if (state_word.load(std::memory_order_acquire) == state) {
+        return (state & ValueSlot::kValidBit) != 0;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+void Parameter::StoreValue(bool valid, uint64_t value) {
+  const uint64_t state = BeginWrite();
+  ValueWord().store(value, std::memory_order_relaxed);
+  if (deadband_ && InDeadband(state, valid, value)) {
+    // The value is a single atomic word, so readers don't need a new
+    // version to get a consistent value.
+    StateWord().store(state, std::memory_order_release);
+    return;
+  }
+  EndWrite(state, valid);
+}
+
+void Parameter::CacheValue(bool valid, double value) {
+  uint64_t bits = 0;
+  switch (data_type_) {
+    case ParameterDataType::BooleanType:
+    case ParameterDataType::UnsignedType:
+      bits = static_cast<uint64_t>(value);
+      break;
+
+    case ParameterDataType::EnumType:
+    case ParameterDataType::SignedType:
+      bits = std::bit_cast<uint64_t>(static_cast<int64_t>(value));
+      break;
+
+    case ParameterDataType::FloatType:
+      bits = std::bit_cast<uint64_t>(value);
+      break;
+
+    case ParameterDataType::StringType: {
+      NumberBuffer buffer;
+      const auto text = FormatNumber(value, buffer);
+      StoreBuffer(valid,
+                  std::make_shared<const ByteArray>(text.cbegin(), text.cend()),
+                  false);
+      return;
+    }
+
+    default:
+      EndWrite(BeginWrite(), valid, false);
+      return;
+  }
+  const uint64_t state = BeginWrite();
+  ValueWord().store(bits, std::memory_order_relaxed);
+  EndWrite(state, valid, false);
+}
+
+void Parameter::StoreBuffer(bool valid, ByteArray&& buffer) {
+  StoreBuffer(valid, std::make_shared<const ByteArray>(std::move(buffer)));
+}
+
+void Parameter::StoreBuffer(bool valid, SharedBuffer buffer, bool report) {
+  if (!buffer_) {
+    EndWrite(BeginWrite(), valid, report);
+    return;
+  }
+  // A text is parsed once here, so numeric reads don't need to parse it.
+  // Text that isn't a number reads as 0, the same as the stream operators.
+  double shadow = 0.0;
+  if (data_type_ == ParameterDataType::StringType) {
+    ParseNumber(std::string_view(reinterpret_cast<const char*>(buffer->data()),
+                                 buffer->size()), shadow);
+  }
+  // The new buffer is created outside the write section. Readers holding
+  // the old buffer keep it alive until they are done.
+  const uint64_t state = BeginWrite();
+  buffer_->store(std::move(buffer), std::memory_order_release);
+  if (data_type_ == ParameterDataType::StringType) {
+    ValueWord().store(std::bit_cast<uint64_t>(shadow),
+                      std::memory_order_relaxed);
+  }
+  EndWrite(state, valid, report);
+}
+
+bool Parameter::InDeadband(uint64_t state, bool valid, uint64_t value) {
+  auto& deadband = *deadband_;
+  const double number = ValueAsDouble(value);
+  const bool was_valid = (state & ValueSlot::kValidBit) != 0;
+  if (deadband.reported && valid == was_valid) {
+    const double change = number - deadband.reference;
+    double band = std::max(deadband.absolute,
+                           deadband.relative * std::abs(deadband.reference));
+    const int direction = change > 0.0 ? 1 : (change < 0.0 ? -1 : 0);
+    if (direction != 0 && deadband.direction != 0 &&
+        direction != deadband.direction) {
+      band += deadband.hysteresis;
+    }
+    if (std::abs(change) <= band) {
+      ++deadband.nof_suppressed;
+      return true;
+    }
+    deadband.direction = direction;
+  }
+  deadband.reported = true;
+  deadband.reference = number;
+  return false;
+}
+
+double Parameter::ValueAsDouble(uint64_t bits) const {
+  switch (data_type_) {
+    case ParameterDataType::FloatType:
+    case ParameterDataType::StringType: // Numeric shadow of the text
+      return std::bit_cast<double>(bits);
+
+    case ParameterDataType::SignedType:
+    case ParameterDataType::EnumType:
+      return static_cast<double>(std::bit_cast<int64_t>(bits));
+
+    case ParameterDataType::UnsignedType:
+    case ParameterDataType::BooleanType:
+      return static_cast<double>(bits);
+
+    case ParameterDataType::ByteArrayType:
+    default:
+      break;
+  }
+  return 0.0;
+}
+
+void Parameter::Deadband(double absolute, double relative,
+                         double hysteresis) {
+  ParameterDeadband deadband;
+  deadband.absolute = absolute;
+  deadband.relative = relative;
+  deadband.hysteresis = hysteresis;
+  if (deadband.Empty()) {
+    deadband_.reset();
+  } else {
+    deadband_ = std::make_unique<ParameterDeadband>(deadband);
+  }
+}
+
+void Parameter::HistorySize(size_t size) {
+  if (size == 0) {
+    history_.reset();
+  } else if (size != HistorySize()) {
+    history_ = std::make_unique<ParameterHistory>(size);
+  }
+}
+
+void Parameter::Bind(ParameterStore* store, size_t index) {
+  const uint64_t state =
+      StateWord().load(std::memory_order_acquire) & ~ValueSlot::kWriteBit;
+  const uint64_t value = ValueWord().load(std::memory_order_acquire);
+  store_ = store;
+  store_index_ = store != nullptr ? static_cast<uint32_t>(index) : 0;
+  ValueWord().store(value, std::memory_order_relaxed);
+  StateWord().store(state, std::memory_order_release);
+}
+
+size_t Parameter::Subscribe(ChangeCallback callback) {
+  return notifier_ != nullptr ? notifier_->Subscribe(std::move(callback),
+                                                     {this}) : 0;
+}
+
+void Parameter::Unsubscribe(size_t subscription) {
+  if (notifier_ != nullptr) {
+    notifier_->Unsubscribe(subscription);
+  }
 }
 
 void Parameter::Init() {
@@ -459,21 +739,31 @@ void Parameter::Exit() {
 void Parameter::SaveXml(IXmlNode& root) const {
   auto& parameter_root = root.AddNode("Parameter");
   parameter_root.SetAttribute("name", name_);
-  if (!identity_.empty()) {
-    parameter_root.SetAttribute("id", identity_);
+  if (!Identity().empty()) {
+    parameter_root.SetAttribute("id", Identity());
   }
 
   parameter_root.SetProperty("Name", name_);
-  parameter_root.SetProperty("Unit", unit_);
-  parameter_root.SetProperty("Description", description_);
+  parameter_root.SetProperty("Unit", Unit());
+  parameter_root.SetProperty("Description", Description());
   parameter_root.SetProperty("Device", device_);
-  parameter_root.SetProperty("Signal", signal_);
-  parameter_root.SetProperty("Identity", identity_);
-  parameter_root.SetProperty("DisplayName", display_name_);
+  parameter_root.SetProperty("Signal", Signal());
+  parameter_root.SetProperty("Identity", Identity());
+  parameter_root.SetProperty("DisplayName", DisplayName());
+  if (!Expression().empty()) {
+    parameter_root.SetProperty("Expression", Expression());
+  }
   parameter_root.SetProperty("DataType", DataTypeAsString());
-  if (!enum_list_.empty()) {
+  parameter_root.SetProperty("HistorySize", HistorySize());
+  if (deadband_) {
+    parameter_root.SetProperty("DeadbandAbsolute", deadband_->absolute);
+    parameter_root.SetProperty("DeadbandRelative", deadband_->relative);
+    parameter_root.SetProperty("Hysteresis", deadband_->hysteresis);
+  }
+  const auto& enum_list = Enums();
+  if (!enum_list.empty()) {
     auto& enum_root = parameter_root.AddNode("EnumList");
-    for (const auto& item : enum_list_) {
+    for (const auto& item : enum_list) {
       auto& enum_node = enum_root.AddNode("Enum");
       enum_node.SetAttribute("id", item.first);
       enum_node.SetAttribute("value", item.second);
@@ -482,17 +772,23 @@ void Parameter::SaveXml(IXmlNode& root) const {
 }
 
 void Parameter::ReadXml(const IXmlNode& root) {
+  auto info = info_ ? *info_ : ParameterInfo();
   name_ = root.Property<std::string>("Name");
-  unit_ = root.Property<std::string>("Unit");
-  description_ = root.Property<std::string>("Description");
+  info.unit = root.Property<std::string>("Unit");
+  info.description = root.Property<std::string>("Description");
   device_ = root.Property<std::string>("Device");
-  signal_ = root.Property<std::string>("Signal");
-  identity_ = root.Property<std::string>("Identity");
-  display_name_ = root.Property<std::string>("DisplayName");
+  info.signal = root.Property<std::string>("Signal");
+  info.identity = root.Property<std::string>("Identity");
+  info.display_name = root.Property<std::string>("DisplayName");
+  info.expression = root.Property<std::string>("Expression");
   DataTypeAsString( root.Property<std::string>("DataType"));
+  HistorySize(root.Property<size_t>("HistorySize", 0));
+  Deadband(root.Property<double>("DeadbandAbsolute", 0.0),
+           root.Property<double>("DeadbandRelative", 0.0),
+           root.Property<double>("Hysteresis", 0.0));
   const auto* enum_root = root.GetNode("EnumList");
   if (enum_root != nullptr) {
-    enum_list_.clear();
+    EnumList enum_list;
     IXmlNode::ChildList list;
     enum_root->GetChildList(list);
     for (const auto* item : list) {
@@ -501,8 +797,15 @@ void Parameter::ReadXml(const IXmlNode& root) {
       }
       const auto id = item->Attribute<int64_t>("id");
       const auto value = item->Attribute<std::string>("value");
-      enum_list_.insert({id,value});
+      enum_list.insert({id,value});
     }
+    info.enum_table = EnumTable::Intern(enum_list);
+  }
+  // Only allocate the info if it holds anything
+  if (info == ParameterInfo()) {
+    info_.reset();
+  } else {
+    info_ = std::make_unique<ParameterInfo>(std::move(info));
   }
 }
 
@@ -10,6 +10,7 @@
 #include <locale>
 #include <util/stringutil.h>
 #include <util/ixmlnode.h>
+#include <util/logstream.h>
 
 using namespace util::string;
 using namespace util::xml;
@@ -47,6 +48,8 @@ namespace workflow {
 bool ParameterContainer::operator==(const ParameterContainer& container) const {
 
   if (ignore_case_name_ != container.ignore_case_name_) return false;
+  if (column_store_ != container.column_store_) return false;
+  if (shared_memory_ != container.shared_memory_) return false;
   const auto device_equal =
       std::ranges::equal(device_list_,container.device_list_,
         [] (const auto& device1, const auto& device2) {
@@ -116,11 +119,29 @@ Parameter* ParameterContainer::CreateParameter(const std::string& device_name,
   if (new_parameter) {
     new_parameter->Name(parameter_name);
     new_parameter->Device(device_name);
+    new_parameter->AttachNotifier(&notifier_);
     parameter_list_.emplace_back(std::move(new_parameter));
   }
   return GetParameter(device_name, parameter_name);
 }
 
+DerivedParameter* ParameterContainer::CreateDerivedParameter(
+    const std::string& device_name, const std::string& parameter_name,
+    const std::string& expression) {
+  if (parameter_name.empty() ||
+      GetParameter(device_name, parameter_name) != nullptr) {
+    return nullptr;
+  }
+  auto new_parameter = std::make_unique<DerivedParameter>(this);
+  auto* parameter = new_parameter.get();
+  parameter->Name(parameter_name);
+  parameter->Device(device_name);
+  parameter->Expression(expression);
+  parameter->AttachNotifier(&notifier_);
+  parameter_list_.emplace_back(std::move(new_parameter));
+  return parameter;
+}
+
 void ParameterContainer::DeleteParameter(const std::string& device_name,
                                          const std::string& parameter_name) {
   auto itr = std::ranges::find_if(parameter_list_, [&] (const auto& parameter) {
@@ -131,8 +152,31 @@ void ParameterContainer::DeleteParameter(const std::string& device_name,
         IEquals(device_name, parameter->Device()) && IEquals(parameter_name, parameter->Name())
         : device_name == parameter->Device() && parameter_name == parameter->Name();
     });
-  if (itr != parameter_list_.end()) {
-    parameter_list_.erase(itr);
+  if (itr == parameter_list_.end()) {
+    return;
+  }
+
+  // Derived parameters that use the parameter shall not keep a pointer to
+  // it. They are compiled again and are invalid if the formula fails.
+  const Parameter* deleted = itr->get();
+  std::vector<DerivedParameter*> dependent_list;
+  for (const auto& parameter : parameter_list_) {
+    auto* derived = dynamic_cast<DerivedParameter*>(parameter.get());
+    if (derived != nullptr &&
+        std::ranges::find(derived->Program().Dependencies(), deleted) !=
+            derived->Program().Dependencies().cend()) {
+      dependent_list.push_back(derived);
+    }
+  }
+  notifier_.Remove(itr->get());
+  parameter_list_.erase(itr);
+
+  for (auto* derived : dependent_list) {
+    if (!derived->Compile()) {
+      LOG_ERROR() << "Invalid formula. Parameter: " << derived->Name()
+                  << ", Error: " << derived->LastError();
+      derived->Valid(false);
+    }
   }
 }
 
@@ -147,6 +191,9 @@ Parameter* ParameterContainer::GetParameter(const std::string& device, const std
 }
 
 void ParameterContainer::Init() {
+  if (column_store_ || !shared_memory_.empty()) {
+    BuildStore();
+  }
   for (auto& parameter : parameter_list_ ) {
     if (parameter) {
       parameter->Init();
@@ -155,7 +202,9 @@ void ParameterContainer::Init() {
 }
 
 void ParameterContainer::Tick() {
-  // By default, it doesn't scan through the parameter list
+  // By default, it doesn't scan through the parameter list. It only
+  // dispatches the changes to the subscribers.
+  notifier_.Dispatch();
 }
 
 void ParameterContainer::Exit() {
@@ -184,8 +233,70 @@ std::vector<std::string> ParameterContainer::Units() const {
 }
 
 void ParameterContainer::Clear() {
+  for (const auto& parameter : parameter_list_) {
+    notifier_.Remove(parameter.get());
+  }
   parameter_list_.clear();
   device_list_.clear();
+  store_.reset();
+  shared_store_.reset();
+}
+
+bool ParameterContainer::Snapshot(StoreSnapshot& snapshot,
+                                  const std::string& device) const {
+  if (!store_) {
+    return false;
+  }
+  if (device.empty()) {
+    return store_->Snapshot(snapshot);
+  }
+
+  std::vector<size_t> index_list;
+  for (const auto& parameter : parameter_list_) {
+    if (!parameter || parameter->Store() != store_.get()) {
+      continue;
+    }
+    const bool match = ignore_case_name_ ? IEquals(device, parameter->Device())
+                                         : device == parameter->Device();
+    if (match) {
+      index_list.push_back(parameter->StoreIndex());
+    }
+  }
+  return store_->Snapshot(snapshot, index_list);
+}
+
+void ParameterContainer::BuildStore() {
+  // Move the values back into the parameters before the old store is
+  // deleted.
+  for (auto& parameter : parameter_list_) {
+    if (parameter) {
+      parameter->Bind(nullptr, 0);
+    }
+  }
+  store_.reset();
+  shared_store_.reset();
+
+  std::unique_ptr<ParameterStore> store;
+  if (!shared_memory_.empty()) {
+    auto shared_store = std::make_unique<SharedParameterStore>();
+    store = shared_store->Create(shared_memory_, parameter_list_);
+    if (store) {
+      shared_store_ = std::move(shared_store);
+    } else {
+      LOG_ERROR() << "Failed to create the shared memory store. Segment: "
+                  << shared_memory_ << ", Error: "
+                  << shared_store->LastError();
+    }
+  }
+  if (!store) {
+    store = std::make_unique<ParameterStore>(parameter_list_.size());
+  }
+  for (size_t index = 0; index < parameter_list_.size(); ++index) {
+    if (parameter_list_[index]) {
+      parameter_list_[index]->Bind(store.get(), index);
+    }
+  }
+  store_ = std::move(store);
 }
 
 bool ParameterContainer::Empty() const {
@@ -200,6 +311,10 @@ void ParameterContainer::SaveXml(IXmlNode& root) const {
   auto& container_root = root.AddNode("ParameterContainer");
 
   container_root.SetProperty("IgnoreCase", ignore_case_name_);
+  container_root.SetProperty("ColumnStore", column_store_);
+  if (!shared_memory_.empty()) {
+    container_root.SetProperty("SharedMemory", shared_memory_);
+  }
 
   if (!device_list_.empty()) {
     auto& device_root = container_root.AddNode("DeviceList");
@@ -226,8 +341,11 @@ void ParameterContainer::ReadXml(const IXmlNode& root) {
     return;
   }
   ignore_case_name_ = container_root->Property<bool>("IgnoreCase");
+  column_store_ = container_root->Property<bool>("ColumnStore", false);
+  shared_memory_ = container_root->Property<std::string>("SharedMemory");
 
-  const auto* device_root = root.GetNode("DeviceList");
+  Clear();
+  const auto* device_root = container_root->GetNode("DeviceList");
   if (device_root != nullptr) {
     IXmlNode::ChildList list;
     device_root->GetChildList(list);
@@ -237,10 +355,11 @@ void ParameterContainer::ReadXml(const IXmlNode& root) {
       }
       auto device = std::make_unique<Device>();
       device->ReadXml(*item);
+      device_list_.emplace_back(std::move(device));
     }
   }
 
-  const auto* parameter_root = root.GetNode("ParameterList");
+  const auto* parameter_root = container_root->GetNode("ParameterList");
   if (parameter_root != nullptr) {
     IXmlNode::ChildList list;
     parameter_root->GetChildList(list);
@@ -248,11 +367,18 @@ void ParameterContainer::ReadXml(const IXmlNode& root) {
       if (item == nullptr || !item->IsTagName("Parameter")) {
         continue;
       }
-      auto parameter = std::make_unique<Parameter>();
+      // A parameter with a formula is a derived parameter
+      std::unique_ptr<Parameter> parameter;
+      if (item->Property<std::string>("Expression").empty()) {
+        parameter = std::make_unique<Parameter>();
+      } else {
+        parameter = std::make_unique<DerivedParameter>(this);
+      }
       parameter->ReadXml(*item);
+      parameter->AttachNotifier(&notifier_);
+      parameter_list_.emplace_back(std::move(parameter));
     }
   }
-
 }
 
 void ParameterContainer::Sort() {
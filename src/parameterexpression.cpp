@@ -0,0 +1,351 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/parameterexpression.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include "workflow/parameter.h"
+
+namespace {
+
+/// The evaluation stack is on the call stack, so it has a fixed size.
+constexpr size_t kMaxStackDepth = 32;
+
+bool IsNameStart(char input) {
+  return std::isalpha(static_cast<unsigned char>(input)) || input == '_';
+}
+
+bool IsNameChar(char input) {
+  return std::isalnum(static_cast<unsigned char>(input)) || input == '_' ||
+         input == '.';
+}
+
+}
+
+namespace workflow {
+
+bool ParameterExpression::Compile(const std::string& text,
+                                  const Resolver& resolver) {
+  Clear();
+  text_ = text;
+  pos_ = 0;
+  depth_ = 0;
+  max_depth_ = 0;
+  resolver_ = &resolver;
+
+  bool compiled = ParseExpression();
+  SkipSpace();
+  if (compiled && pos_ < text_.size()) {
+    compiled = Error("Unexpected character");
+  }
+  if (compiled && max_depth_ > kMaxStackDepth) {
+    compiled = Error("The expression is too complex");
+  }
+  resolver_ = nullptr;
+  text_ = {};
+  if (!compiled) {
+    program_.clear();
+    dependency_list_.clear();
+  }
+  return compiled;
+}
+
+void ParameterExpression::Clear() {
+  program_.clear();
+  dependency_list_.clear();
+  last_error_.clear();
+}
+
+bool ParameterExpression::Evaluate(double& value) const {
+  std::array<double, kMaxStackDepth> stack {};
+  size_t top = 0; // Number of values on the stack
+  bool valid = true;
+  for (const auto& instruction : program_) {
+    switch (instruction.op_code) {
+      case OpCode::Constant:
+        stack[top++] = instruction.constant;
+        break;
+
+      case OpCode::Load: {
+        double input = 0.0;
+        valid = instruction.parameter->GetValue(input) && valid;
+        stack[top++] = input;
+        break;
+      }
+
+      case OpCode::Add:
+        --top;
+        stack[top - 1] += stack[top];
+        break;
+
+      case OpCode::Subtract:
+        --top;
+        stack[top - 1] -= stack[top];
+        break;
+
+      case OpCode::Multiply:
+        --top;
+        stack[top - 1] *= stack[top];
+        break;
+
+      case OpCode::Divide:
+        --top;
+        stack[top - 1] /= stack[top];
+        break;
+
+      case OpCode::Power:
+        --top;
+        stack[top - 1] = std::pow(stack[top - 1], stack[top]);
+        break;
+
+      case OpCode::Negate:
+        stack[top - 1] = -stack[top - 1];
+        break;
+
+      case OpCode::Abs:
+        stack[top - 1] = std::abs(stack[top - 1]);
+        break;
+
+      case OpCode::Sqrt:
+        stack[top - 1] = std::sqrt(stack[top - 1]);
+        break;
+
+      case OpCode::Min:
+        --top;
+        stack[top - 1] = std::min(stack[top - 1], stack[top]);
+        break;
+
+      case OpCode::Max:
+        --top;
+        stack[top - 1] = std::max(stack[top - 1], stack[top]);
+        break;
+
+      default:
+        break;
+    }
+  }
+  value = top > 0 ? stack[top - 1] : 0.0;
+  return valid && top == 1;
+}
+
+void ParameterExpression::SkipSpace() {
+  while (pos_ < text_.size() &&
+         std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+    ++pos_;
+  }
+}
+
+bool ParameterExpression::Error(const std::string& error) {
+  if (last_error_.empty()) {
+    last_error_ = error + " at position " + std::to_string(pos_) + ".";
+  }
+  return false;
+}
+
+void ParameterExpression::Emit(OpCode op_code, double constant,
+                               Parameter* parameter) {
+  switch (op_code) {
+    case OpCode::Constant:
+    case OpCode::Load:
+      max_depth_ = std::max(max_depth_, ++depth_);
+      break;
+
+    case OpCode::Negate:
+    case OpCode::Abs:
+    case OpCode::Sqrt:
+      break;
+
+    default: // Binary operators
+      --depth_;
+      break;
+  }
+  program_.push_back({op_code, constant, parameter});
+}
+
+bool ParameterExpression::ParseExpression() {
+  if (!ParseTerm()) {
+    return false;
+  }
+  for (SkipSpace(); pos_ < text_.size(); SkipSpace()) {
+    const char oper = text_[pos_];
+    if (oper != '+' && oper != '-') {
+      break;
+    }
+    ++pos_;
+    if (!ParseTerm()) {
+      return false;
+    }
+    Emit(oper == '+' ? OpCode::Add : OpCode::Subtract);
+  }
+  return true;
+}
+
+bool ParameterExpression::ParseTerm() {
+  if (!ParseUnary()) {
+    return false;
+  }
+  for (SkipSpace(); pos_ < text_.size(); SkipSpace()) {
+    const char oper = text_[pos_];
+    if (oper != '*' && oper != '/') {
+      break;
+    }
+    ++pos_;
+    if (!ParseUnary()) {
+      return false;
+    }
+    Emit(oper == '*' ? OpCode::Multiply : OpCode::Divide);
+  }
+  return true;
+}
+
+bool ParameterExpression::ParseUnary() {
+  SkipSpace();
+  if (pos_ < text_.size() && text_[pos_] == '-') {
+    ++pos_;
+    if (!ParseUnary()) {
+      return false;
+    }
+    Emit(OpCode::Negate);
+    return true;
+  }
+  if (pos_ < text_.size() && text_[pos_] == '+') {
+    ++pos_;
+    return ParseUnary();
+  }
+  return ParsePower();
+}
+
+bool ParameterExpression::ParsePower() {
+  if (!ParsePrimary()) {
+    return false;
+  }
+  SkipSpace();
+  if (pos_ < text_.size() && text_[pos_] == '^') {
+    ++pos_;
+    // Right associative, 2^3^2 = 2^(3^2)
+    if (!ParseUnary()) {
+      return false;
+    }
+    Emit(OpCode::Power);
+  }
+  return true;
+}
+
+bool ParameterExpression::ParsePrimary() {
+  SkipSpace();
+  if (pos_ >= text_.size()) {
+    return Error("Unexpected end of expression");
+  }
+
+  const char first = text_[pos_];
+  if (first == '(') {
+    ++pos_;
+    if (!ParseExpression()) {
+      return false;
+    }
+    SkipSpace();
+    if (pos_ >= text_.size() || text_[pos_] != ')') {
+      return Error("Missing ')'");
+    }
+    ++pos_;
+    return true;
+  }
+
+  if (std::isdigit(static_cast<unsigned char>(first)) || first == '.') {
+    double constant = 0.0;
+    const auto [last, error] = std::from_chars(text_.data() + pos_,
+                                               text_.data() + text_.size(),
+                                               constant);
+    if (error != std::errc()) {
+      return Error("Invalid number");
+    }
+    pos_ = static_cast<size_t>(last - text_.data());
+    Emit(OpCode::Constant, constant);
+    return true;
+  }
+
+  if (first == '{') {
+    const size_t end = text_.find('}', pos_);
+    if (end == std::string_view::npos) {
+      return Error("Missing '}'");
+    }
+    const size_t start = pos_;
+    const std::string name(text_.substr(pos_ + 1, end - pos_ - 1));
+    pos_ = end + 1;
+    return ParseReference(name, start);
+  }
+
+  if (!IsNameStart(first)) {
+    return Error("Unexpected character");
+  }
+  const size_t start = pos_;
+  while (pos_ < text_.size() && IsNameChar(text_[pos_])) {
+    ++pos_;
+  }
+  const std::string name(text_.substr(start, pos_ - start));
+  SkipSpace();
+  if (pos_ >= text_.size() || text_[pos_] != '(') {
+    return ParseReference(name, start);
+  }
+
+  // Function call
+  OpCode op_code;
+  size_t nof_arguments = 1;
+  if (name == "abs") {
+    op_code = OpCode::Abs;
+  } else if (name == "sqrt") {
+    op_code = OpCode::Sqrt;
+  } else if (name == "min") {
+    op_code = OpCode::Min;
+    nof_arguments = 2;
+  } else if (name == "max") {
+    op_code = OpCode::Max;
+    nof_arguments = 2;
+  } else {
+    pos_ = start;
+    return Error("Unknown function '" + name + "'");
+  }
+  ++pos_;
+  for (size_t argument = 0; argument < nof_arguments; ++argument) {
+    if (argument > 0) {
+      SkipSpace();
+      if (pos_ >= text_.size() || text_[pos_] != ',') {
+        return Error("Missing ','");
+      }
+      ++pos_;
+    }
+    if (!ParseExpression()) {
+      return false;
+    }
+  }
+  SkipSpace();
+  if (pos_ >= text_.size() || text_[pos_] != ')') {
+    return Error("Missing ')'");
+  }
+  ++pos_;
+  Emit(op_code);
+  return true;
+}
+
+bool ParameterExpression::ParseReference(const std::string& name,
+                                         size_t start) {
+  auto* parameter = resolver_ != nullptr && *resolver_ ? (*resolver_)(name)
+                                                       : nullptr;
+  if (parameter == nullptr) {
+    pos_ = start;
+    return Error("Unknown parameter '" + name + "'");
+  }
+  if (std::ranges::find(dependency_list_, parameter) ==
+      dependency_list_.cend()) {
+    dependency_list_.push_back(parameter);
+  }
+  Emit(OpCode::Load, 0.0, parameter);
+  return true;
+}
+
+}  // namespace workflow
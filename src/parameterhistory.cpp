@@ -0,0 +1,93 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/parameterhistory.h"
+#include <algorithm>
+#include <bit>
+
+namespace workflow {
+
+ParameterHistory::ParameterHistory(size_t capacity)
+: capacity_(std::max<size_t>(capacity, 1)),
+  entry_list_(std::make_unique<Entry[]>(capacity_)) {
+}
+
+size_t ParameterHistory::Size() const {
+  return static_cast<size_t>(std::min<uint64_t>(NofSamples(), capacity_));
+}
+
+void ParameterHistory::Add(uint64_t timestamp, bool valid, double value) {
+  const uint64_t sample = head_.load(std::memory_order_relaxed);
+  auto& entry = entry_list_[sample % capacity_];
+  entry.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.timestamp.store(timestamp, std::memory_order_relaxed);
+  entry.value.store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+  entry.valid.store(valid, std::memory_order_relaxed);
+  entry.sequence.store(sample + 1, std::memory_order_release);
+  head_.store(sample + 1, std::memory_order_release);
+}
+
+void ParameterHistory::Range(uint64_t from, uint64_t to,
+                             HistoryList& sample_list) const {
+  sample_list.clear();
+  const uint64_t head = NofSamples();
+  const uint64_t first = head > capacity_ ? head - capacity_ : 0;
+  for (uint64_t sample = first; sample < head; ++sample) {
+    const auto& entry = entry_list_[sample % capacity_];
+    if (entry.sequence.load(std::memory_order_acquire) != sample + 1) {
+      continue; // Overwritten by the writer
+    }
+    HistorySample copy;
+    copy.timestamp = entry.timestamp.load(std::memory_order_relaxed);
+    copy.value = std::bit_cast<double>(
+        entry.value.load(std::memory_order_relaxed));
+    copy.valid = entry.valid.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.sequence.load(std::memory_order_relaxed) != sample + 1) {
+      continue;
+    }
+    if (copy.timestamp >= from && copy.timestamp <= to) {
+      sample_list.push_back(copy);
+    }
+  }
+}
+
+bool ParameterHistory::Statistics(uint64_t from, uint64_t to,
+                                  HistoryStatistics& statistics) const {
+  statistics = {};
+  HistoryList sample_list;
+  Range(from, to, sample_list);
+
+  const HistorySample* first = nullptr;
+  const HistorySample* last = nullptr;
+  double sum = 0.0;
+  for (const auto& sample : sample_list) {
+    if (!sample.valid) {
+      continue;
+    }
+    if (first == nullptr) {
+      first = &sample;
+      statistics.min = sample.value;
+      statistics.max = sample.value;
+    }
+    last = &sample;
+    statistics.min = std::min(statistics.min, sample.value);
+    statistics.max = std::max(statistics.max, sample.value);
+    sum += sample.value;
+    ++statistics.count;
+  }
+  if (statistics.count == 0) {
+    return false;
+  }
+  statistics.average = sum / static_cast<double>(statistics.count);
+  if (last->timestamp > first->timestamp) {
+    statistics.rate = (last->value - first->value) * 1e9 /
+        static_cast<double>(last->timestamp - first->timestamp);
+  }
+  return true;
+}
+
+}  // namespace workflow
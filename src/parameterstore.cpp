@@ -0,0 +1,136 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/parameterstore.h"
+#include <thread>
+
+namespace workflow {
+
+ParameterStore::ParameterStore(size_t size)
+: size_(size),
+  block_(std::make_unique<std::atomic<uint64_t>[]>(2 + 4 * size)) {
+  AssignColumns(block_.get());
+}
+
+ParameterStore::ParameterStore(size_t size, void* block)
+: size_(size) {
+  AssignColumns(static_cast<std::atomic<uint64_t>*>(block));
+}
+
+void ParameterStore::AssignColumns(std::atomic<uint64_t>* block) {
+  sequence_ = block;
+  epoch_ = block + 1;
+  state_list_ = block + 2;
+  value_list_ = state_list_ + size_;
+  timestamp_list_ = value_list_ + size_;
+  sequence_list_ = timestamp_list_ + size_;
+}
+
+bool ParameterStore::Load(size_t index, uint64_t& value) const {
+  const auto& state_word = state_list_[index];
+  for (size_t retry = 0; max_retries_ == 0 || retry <= max_retries_;
+       ++retry) {
+    const uint64_t state = state_word.load(std::memory_order_acquire);
+    if ((state & ValueSlot::kWriteBit) == 0) {
+      value = value_list_[index].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (state_word.load(std::memory_order_relaxed) == state) {
+        return (state & ValueSlot::kValidBit) != 0;
+      }
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+void ParameterStore::Stamp(size_t index, uint64_t timestamp) {
+  timestamp_list_[index].store(timestamp, std::memory_order_relaxed);
+  sequence_list_[index].store(sequence_->fetch_add(1) + 1,
+                              std::memory_order_relaxed);
+}
+
+void ParameterStore::BeginGroup() {
+  group_lock_.lock();
+  epoch_->fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ParameterStore::EndGroup() {
+  epoch_->fetch_add(1, std::memory_order_acq_rel);
+  group_lock_.unlock();
+}
+
+bool ParameterStore::Snapshot(StoreSnapshot& snapshot) const {
+  snapshot.index_list.clear();
+  return CopyEntries(snapshot, false);
+}
+
+bool ParameterStore::Snapshot(StoreSnapshot& snapshot,
+                              const std::vector<size_t>& index_list) const {
+  snapshot.index_list.clear();
+  for (const size_t index : index_list) {
+    if (index < size_) {
+      snapshot.index_list.push_back(index);
+    }
+  }
+  return CopyEntries(snapshot, true);
+}
+
+bool ParameterStore::CopyEntry(size_t index, size_t pos,
+                               StoreSnapshot& snapshot) const {
+  const uint64_t state = state_list_[index].load(std::memory_order_acquire);
+  if ((state & ValueSlot::kWriteBit) != 0) {
+    return false;
+  }
+  snapshot.value_list[pos] = value_list_[index].load(std::memory_order_relaxed);
+  snapshot.timestamp_list[pos] =
+      timestamp_list_[index].load(std::memory_order_relaxed);
+  snapshot.sequence_list[pos] =
+      sequence_list_[index].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  snapshot.state_list[pos] = state;
+  return state_list_[index].load(std::memory_order_relaxed) == state;
+}
+
+bool ParameterStore::CopyEntries(StoreSnapshot& snapshot, bool subset) const {
+  const size_t count = subset ? snapshot.index_list.size() : size_;
+  snapshot.state_list.resize(count);
+  snapshot.value_list.resize(count);
+  snapshot.timestamp_list.resize(count);
+  snapshot.sequence_list.resize(count);
+  snapshot.nof_retries = 0;
+
+  // The copy is consistent if no value was written and no group was
+  // active while it was copied.
+  while (max_retries_ == 0 || snapshot.nof_retries <= max_retries_) {
+    const uint64_t epoch = epoch_->load(std::memory_order_acquire);
+    const uint64_t sequence = LastSequence();
+    bool consistent = (epoch % 2) == 0;
+    for (size_t pos = 0; consistent && pos < count; ++pos) {
+      consistent = CopyEntry(subset ? snapshot.index_list[pos] : pos, pos,
+                             snapshot);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (consistent && sequence == sequence_->load(std::memory_order_relaxed) &&
+        epoch == epoch_->load(std::memory_order_relaxed)) {
+      snapshot.sequence = sequence;
+      return true;
+    }
+    ++snapshot.nof_retries;
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+void ParameterStore::ChangedSince(uint64_t sequence,
+                                  std::vector<size_t>& index_list) const {
+  index_list.clear();
+  for (size_t index = 0; index < size_; ++index) {
+    if (sequence_list_[index].load(std::memory_order_relaxed) > sequence) {
+      index_list.push_back(index);
+    }
+  }
+}
+
+}  // namespace workflow
@@ -0,0 +1,83 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/parametertransaction.h"
+#include <algorithm>
+#include <chrono>
+#include "workflow/parametercontainer.h"
+
+namespace {
+
+/** @brief Keeps the notifier in batch mode during its lifetime. */
+class BatchGuard {
+ public:
+  explicit BatchGuard(workflow::ChangeNotifier& notifier)
+  : notifier_(notifier) {
+    notifier_.BeginBatch();
+  }
+  ~BatchGuard() {
+    notifier_.EndBatch();
+  }
+  BatchGuard(const BatchGuard& guard) = delete;
+  BatchGuard& operator = (const BatchGuard& guard) = delete;
+ private:
+  workflow::ChangeNotifier& notifier_;
+};
+
+/** @brief Holds a store group during its lifetime. A null store is ignored. */
+class GroupGuard {
+ public:
+  explicit GroupGuard(workflow::ParameterStore* store)
+  : store_(store) {
+    if (store_ != nullptr) {
+      store_->BeginGroup();
+    }
+  }
+  ~GroupGuard() {
+    if (store_ != nullptr) {
+      store_->EndGroup();
+    }
+  }
+  GroupGuard(const GroupGuard& guard) = delete;
+  GroupGuard& operator = (const GroupGuard& guard) = delete;
+ private:
+  workflow::ParameterStore* store_;
+};
+
+}  // namespace
+
+namespace workflow {
+
+ParameterTransaction::ParameterTransaction(ParameterContainer& container)
+: container_(container) {
+}
+
+uint64_t ParameterTransaction::Commit() {
+  const auto start = std::chrono::steady_clock::now();
+  {
+    // The guards end the group and the batch even if a write throws.
+    // Otherwise, the store readers and the next group writer would block.
+    BatchGuard batch(container_.Notifier());
+    GroupGuard group(container_.GetStore());
+    for (auto& item : item_list_) {
+      if (item.parameter == nullptr) {
+        continue;
+      }
+      std::visit([&] (const auto& value) {
+        item.parameter->SetValue(item.valid, value);
+      }, item.value);
+    }
+  }
+  item_list_.clear();
+
+  const auto latency = std::chrono::steady_clock::now() - start;
+  last_latency_ = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+  max_latency_ = std::max(max_latency_, last_latency_);
+  ++nof_commits_;
+  return last_latency_;
+}
+
+}  // namespace workflow
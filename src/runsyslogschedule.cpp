@@ -5,16 +5,19 @@
 
 #include "runsyslogschedule.h"
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <util/syslogmessage.h>
 #include "workflow/workflow.h"
+#include "workflow/workflowpool.h"
+#include "workflow/workflowqueue.h"
 
 #include "template_names.icc"
 
 using namespace boost::program_options;
 using namespace util::string;
 using namespace util::syslog;
-using SyslogList = std::vector<util::syslog::SyslogMessage>;
 
 namespace workflow {
 
@@ -34,9 +37,15 @@ RunSyslogSchedule::RunSyslogSchedule(const ITask& source)
   ParseArguments();
 }
 
+std::unique_ptr<ITask> RunSyslogSchedule::Clone() const {
+  return std::make_unique<RunSyslogSchedule>(*this);
+}
+
 void RunSyslogSchedule::Init() {
   ITask::Init();
   ParseArguments();
+  // A clone shall not share the drop counter with its source
+  nof_undelivered_ = std::make_shared<std::atomic<size_t>>(0);
   IsOk(true);
 }
 
@@ -49,6 +58,27 @@ void RunSyslogSchedule::Tick() {
     return;
   }
 
+  auto* syslog_list = workflow->GetData<SyslogList>();
+  if (syslog_list == nullptr) {
+    LastError("No syslog list found");
+    IsOk(false);
+    return;
+  }
+
+  // The target is looked up on each tick, as the workflow or queue may be
+  // replaced or deleted meanwhile. The lookups are indexed.
+  if (!queue_name_.empty()) {
+    auto* queue = workflow->GetQueue(queue_name_);
+    if (queue == nullptr) {
+      LastError("No queue found");
+      IsOk(false);
+      return;
+    }
+    ForwardToQueue(*queue, *syslog_list);
+    IsOk(true);
+    return;
+  }
+
   auto* remote = workflow->GetWorkflow(schedule_name_);
   if (remote == nullptr) {
     LastError("No remote schedule found");
@@ -56,24 +86,110 @@ void RunSyslogSchedule::Tick() {
     return;
   }
 
-  auto* syslog_list = workflow->GetData<SyslogList>();
-  if (syslog_list == nullptr) {
-    LastError("No syslog list found");
-    IsOk(false);
-    return;
+  if (auto* pool = remote->Pool(); pool != nullptr) {
+    ForwardToPool(*pool, *syslog_list);
+  } else if (batch_) {
+    ForwardBatch(*remote, syslog_list->begin(), syslog_list->end());
+  } else {
+    ForwardMessages(*remote, syslog_list->cbegin(), syslog_list->cend());
+  }
+  if (batch_) {
+    // The messages have been moved to the remote workflow.
+    syslog_list->clear();
   }
 
-  auto* remote_msg = remote->GetData<SyslogMessage>();
-  if (remote_msg == nullptr) {
-    LastError("No remote data found");
+  // A remote strand may run the updates later in another thread. Those
+  // drops are reported by a later tick.
+  if (const size_t nof_undelivered = nof_undelivered_->exchange(0);
+      nof_undelivered > 0) {
+    std::ostringstream msg;
+    msg << "No remote data found. Dropped messages: " << nof_undelivered;
+    LastError(msg.str());
     IsOk(false);
     return;
   }
+  IsOk(true);
+}
+
+void RunSyslogSchedule::ForwardMessages(Workflow& remote,
+                                        SyslogList::const_iterator first,
+                                        SyslogList::const_iterator last) {
+  // The message is written by the thread that runs the remote tick, so a
+  // strand doesn't let the next message overwrite it before it is consumed.
+  for (auto itr = first; itr != last; ++itr) {
+    remote.Tick([msg = *itr, undelivered = nof_undelivered_]
+                (Workflow& workflow) {
+      if (auto* remote_msg = workflow.GetData<SyslogMessage>();
+          remote_msg != nullptr) {
+        *remote_msg = msg;
+        workflow.DataChanged();
+      } else {
+        ++*undelivered;
+      }
+    });
+  }
+}
+
+void RunSyslogSchedule::ForwardBatch(Workflow& remote,
+                                     SyslogList::iterator first,
+                                     SyslogList::iterator last) {
+  // Moves the messages in batches of max batch size. The remote workflow
+  // is ticked once per batch.
+  while (first != last) {
+    const auto size = static_cast<size_t>(std::distance(first, last));
+    const auto batch_end = batch_size_ > 0 && batch_size_ < size ?
+                          first + static_cast<ptrdiff_t>(batch_size_) : last;
+    SyslogList batch(std::make_move_iterator(first),
+                     std::make_move_iterator(batch_end));
+    remote.Tick([batch = std::move(batch), undelivered = nof_undelivered_]
+                (Workflow& workflow) mutable {
+      if (auto* remote_list = workflow.GetData<SyslogList>();
+          remote_list != nullptr) {
+        *remote_list = std::move(batch);
+        workflow.DataChanged();
+      } else {
+        *undelivered += batch.size();
+      }
+    });
+    first = batch_end;
+  }
+}
+
+void RunSyslogSchedule::ForwardToPool(WorkflowPool& pool,
+                                      SyslogList& syslog_list) {
+  // Messages from the same host are sent to the same instance, so each
+  // instance sees its messages in order.
+  std::vector<SyslogList> partition_list(pool.Size());
+  for (auto& msg : syslog_list) {
+    const auto index = pool.Partition(msg.Hostname());
+    if (batch_) {
+      partition_list[index].emplace_back(std::move(msg));
+    } else {
+      partition_list[index].emplace_back(msg);
+    }
+  }
+
+  pool.Run([&] (Workflow& instance, size_t index) {
+    auto& msg_list = partition_list[index];
+    if (msg_list.empty()) {
+      return;
+    }
+    if (batch_) {
+      ForwardBatch(instance, msg_list.begin(), msg_list.end());
+    } else {
+      ForwardMessages(instance, msg_list.cbegin(), msg_list.cend());
+    }
+  });
+}
 
-  for (const auto& msg : *syslog_list) {
-    *remote_msg = msg;
-    remote->Tick();
+void RunSyslogSchedule::ForwardToQueue(WorkflowQueue& queue,
+                                       SyslogList& syslog_list) {
+  // Full queues drop messages according to the queue drop policy. The
+  // drops are counted by the queue.
+  for (auto& msg : syslog_list) {
+    queue.Push(std::move(msg));
   }
+  syslog_list.clear();
 }
 
 void RunSyslogSchedule::ParseArguments() {
@@ -82,6 +198,15 @@ void RunSyslogSchedule::ParseArguments() {
     desc.add_options() ("name,N",
                        value<std::string>(&schedule_name_),
                        "Name of schedule to run" );
+    desc.add_options() ("batch,B",
+                       bool_switch(&batch_),
+                       "Forward the message list in one tick" );
+    desc.add_options() ("batch-size,S",
+                       value<size_t>(&batch_size_)->default_value(0),
+                       "Max messages per batch (0 = all)" );
+    desc.add_options() ("queue,Q",
+                       value<std::string>(&queue_name_)->default_value(""),
+                       "Name of queue to push messages to" );
 
     const auto arg_list = split_unix(Arguments());
     basic_command_line_parser parser(arg_list);
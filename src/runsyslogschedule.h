@@ -4,21 +4,61 @@
  */
 
 #pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <util/syslogmessage.h>
 #include "workflow/itask.h"
 
 
 namespace workflow {
 
+class WorkflowPool;
+class WorkflowQueue;
+using SyslogList = std::vector<util::syslog::SyslogMessage>;
+
+class Workflow;
+
+/**
+ * @brief Forwards the syslog messages to another workflow (schedule).
+ *
+ * By default, each message is copied into the remote workflow data
+ * (SyslogMessage) and the remote workflow is ticked once per message. With
+ * the '--batch' argument, the messages are moved into the remote workflow
+ * data (SyslogList) and the remote workflow is ticked once per batch. The
+ * '--batch-size' argument limits the number of messages in a batch.
+ *
+ * The remote workflow data is only accessed by the remote tick. Messages
+ * that find no remote data are dropped and reported by the task.
+ *
+ * With the '--queue' argument, the messages are moved into a workflow queue
+ * instead. The task doesn't wait for the consumer workflow, which is ticked
+ * by its queue event in another thread.
+ */
 class RunSyslogSchedule : public ITask {
  public:
   RunSyslogSchedule();
   explicit RunSyslogSchedule(const ITask& source);
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override;
   void Init() override;
   void Tick() override;
 
  private:
   std::string schedule_name_ = "SyslogSchedule"; ///<  Schedule name
+  bool batch_ = false; ///< Forward the list instead of each message
+  size_t batch_size_ = 0; ///< Max messages per batch. 0 = all.
+  std::string queue_name_; ///< Forward to a queue instead of a schedule
+  /// Messages without remote data. Shared with the queued remote updates.
+  std::shared_ptr<std::atomic<size_t>> nof_undelivered_ =
+      std::make_shared<std::atomic<size_t>>(0);
+
   void ParseArguments();
+  void ForwardMessages(Workflow& remote, SyslogList::const_iterator first,
+                       SyslogList::const_iterator last);
+  void ForwardBatch(Workflow& remote, SyslogList::iterator first,
+                    SyslogList::iterator last);
+  void ForwardToPool(WorkflowPool& pool, SyslogList& syslog_list);
+  void ForwardToQueue(WorkflowQueue& queue, SyslogList& syslog_list);
 };
 
 }  // namespace workflow
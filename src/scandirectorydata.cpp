@@ -32,6 +32,10 @@ ScanDirectoryData::ScanDirectoryData(const ITask& source)
   ParseArguments();
 }
 
+std::unique_ptr<ITask> ScanDirectoryData::Clone() const {
+  return std::make_unique<ScanDirectoryData>(*this);
+}
+
 void ScanDirectoryData::Init() {
   ITask::Init();
   ParseArguments();
@@ -58,6 +62,7 @@ void ScanDirectoryData::Tick() {
     }
 
     const auto scan = data->ScanDirectory();
+    workflow->DataChanged();
     if (!scan) {
       LastError(data->LastError());
       IsOk(false);
@@ -13,6 +13,7 @@ class ScanDirectoryData : public ITask {
  public:
   ScanDirectoryData();
   explicit ScanDirectoryData(const ITask& source);
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override;
   void Init() override;
   void Tick() override;
  private:
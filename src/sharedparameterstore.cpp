@@ -0,0 +1,367 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/sharedparameterstore.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#endif
+
+using namespace boost::interprocess;
+
+namespace {
+
+constexpr uint64_t kMagic = 0x3145524F'54534657; ///< "WFSTORE1" in memory
+constexpr uint32_t kVersion = 2;
+constexpr size_t kStoreOffset = 64; ///< Header rounded up to a cache line
+/// Read retries before a reader gives up on a value that the owner may
+/// have left half written.
+constexpr size_t kMaxReadRetries = 10'000;
+/// Number of checks of a new segment before it is seen as left behind.
+constexpr size_t kMaxClaimRetries = 10;
+constexpr std::string_view kInUse = "The segment is in use by another owner.";
+
+/**
+ * @brief First bytes in the segment.
+ *
+ * All fields are fixed size, so a reader built by another compiler can map
+ * the header. The online word is set last by the owner. The owner word is
+ * the process id of the owner. It is claimed with a compare and swap, so
+ * only one process may create or replace the segment.
+ */
+struct SegmentHeader {
+  uint64_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint32_t header_size = sizeof(SegmentHeader);
+  uint64_t nof_parameters = 0;
+  uint64_t store_offset = kStoreOffset;
+  uint64_t schema_offset = 0;
+  uint64_t schema_size = 0;
+  std::atomic<uint64_t> online = 0;
+  std::atomic<uint64_t> owner = 0;
+};
+static_assert(sizeof(SegmentHeader) <= kStoreOffset);
+
+uint64_t CurrentProcessId() {
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return static_cast<uint64_t>(getpid());
+#endif
+}
+
+bool IsProcessAlive(uint64_t pid) {
+  if (pid == 0) {
+    return false;
+  }
+#ifdef _WIN32
+  HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE,
+                               static_cast<DWORD>(pid));
+  if (process == nullptr) {
+    return GetLastError() == ERROR_ACCESS_DENIED;
+  }
+  DWORD exit_code = 0;
+  const bool alive = GetExitCodeProcess(process, &exit_code) != 0 &&
+                     exit_code == STILL_ACTIVE;
+  CloseHandle(process);
+  return alive;
+#else
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+/**
+ * @brief Claims a segment that is left behind by a dead owner.
+ *
+ * A new segment is sized and claimed by its creator right away, so a
+ * segment without an owner is checked a few times before it is claimed.
+ * @param name Segment name.
+ * @return True if the caller may remove the segment.
+ */
+bool ClaimSegment(const std::string& name) {
+  try {
+    shared_memory_object segment(open_only, name.c_str(), read_write);
+    for (size_t retry = 1; retry <= kMaxClaimRetries; ++retry) {
+      offset_t size = 0;
+      if (segment.get_size(size) &&
+          size >= static_cast<offset_t>(kStoreOffset)) {
+        mapped_region region(segment, read_write, 0, kStoreOffset);
+        auto* header = static_cast<SegmentHeader*>(region.get_address());
+        uint64_t owner = header->owner.load(std::memory_order_acquire);
+        if (IsProcessAlive(owner)) {
+          return false;
+        }
+        if (owner != 0 || retry == kMaxClaimRetries) {
+          return header->owner.compare_exchange_strong(owner,
+                                                       CurrentProcessId());
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  } catch (const interprocess_exception&) {
+    // The segment is gone or can't be mapped. It is removed anyway.
+  }
+  return true;
+}
+
+void AppendField(std::string& schema, const std::string& field, char end) {
+  // Tabs and new lines are the delimiters of the table.
+  std::string text = field;
+  std::ranges::replace(text, '\t', ' ');
+  std::ranges::replace(text, '\n', ' ');
+  schema += text;
+  schema += end;
+}
+
+}  // namespace
+
+namespace workflow {
+
+SharedParameterStore::SharedParameterStore() = default;
+
+SharedParameterStore::~SharedParameterStore() {
+  Close();
+}
+
+std::unique_ptr<ParameterStore> SharedParameterStore::Create(
+    const std::string& name,
+    const std::vector<std::unique_ptr<Parameter>>& parameter_list) {
+  Close();
+  last_error_.clear();
+
+  std::string schema;
+  for (size_t index = 0; index < parameter_list.size(); ++index) {
+    const auto* parameter = parameter_list[index].get();
+    if (parameter == nullptr) {
+      continue;
+    }
+    schema += std::to_string(index);
+    schema += '\t';
+    AppendField(schema, parameter->Device(), '\t');
+    AppendField(schema, parameter->Name(), '\t');
+    AppendField(schema, parameter->Unit(), '\t');
+    AppendField(schema, parameter->DataTypeAsString(), '\n');
+  }
+
+  const size_t nof_parameters = parameter_list.size();
+  const size_t schema_offset =
+      kStoreOffset + ParameterStore::BlockSize(nof_parameters);
+  const size_t size = schema_offset + schema.size();
+  // A segment with the same name is only replaced if its owner is dead.
+  // The create is retried if another process creates a segment meanwhile.
+  for (size_t attempt = 0; !region_ && attempt < 3; ++attempt) {
+    try {
+      shared_memory_object segment(create_only, name.c_str(), read_write);
+      segment.truncate(static_cast<offset_t>(size));
+      auto region = std::make_unique<mapped_region>(segment, read_write);
+      auto* header = static_cast<SegmentHeader*>(region->get_address());
+      uint64_t owner = 0;
+      if (!header->owner.compare_exchange_strong(owner, CurrentProcessId())) {
+        last_error_ = kInUse;
+        return {};
+      }
+      region_ = std::move(region);
+    } catch (const interprocess_exception& err) {
+      if (err.get_error_code() != already_exists_error) {
+        last_error_ = err.what();
+        return {};
+      }
+      if (!ClaimSegment(name)) {
+        last_error_ = kInUse;
+        return {};
+      }
+      shared_memory_object::remove(name.c_str());
+    }
+  }
+  if (!region_) {
+    last_error_ = "Failed to create the segment.";
+    return {};
+  }
+  name_ = name;
+  owner_ = true;
+
+  // The header is filled in field by field, as the owner word is already
+  // claimed. The rest of the new segment is zero filled by the truncate.
+  auto* memory = static_cast<char*>(region_->get_address());
+  std::memset(memory + kStoreOffset, 0, size - kStoreOffset);
+  auto* header = reinterpret_cast<SegmentHeader*>(memory);
+  header->magic = kMagic;
+  header->version = kVersion;
+  header->header_size = sizeof(SegmentHeader);
+  header->store_offset = kStoreOffset;
+  header->nof_parameters = nof_parameters;
+  header->schema_offset = schema_offset;
+  header->schema_size = schema.size();
+  std::memcpy(memory + schema_offset, schema.data(), schema.size());
+
+  auto store = std::make_unique<ParameterStore>(nof_parameters,
+                                                memory + kStoreOffset);
+  header->online.store(1, std::memory_order_release);
+  return store;
+}
+
+bool SharedParameterStore::Open(const std::string& name) {
+  Close();
+  last_error_.clear();
+  try {
+    shared_memory_object segment(open_only, name.c_str(), read_only);
+    region_ = std::make_unique<mapped_region>(segment, read_only);
+  } catch (const interprocess_exception& err) {
+    last_error_ = err.what();
+    region_.reset();
+    return false;
+  }
+  name_ = name;
+
+  const size_t size = region_->get_size();
+  const auto* memory = static_cast<const char*>(region_->get_address());
+  const auto* header = reinterpret_cast<const SegmentHeader*>(memory);
+  if (size < kStoreOffset) {
+    last_error_ = "The segment is too small.";
+  } else if (header->online.load(std::memory_order_acquire) == 0) {
+    last_error_ = "The segment is off-line.";
+  } else if (header->magic != kMagic || header->version != kVersion) {
+    last_error_ = "The segment is not a parameter store.";
+  } else if (!IsProcessAlive(header->owner.load(std::memory_order_acquire))) {
+    last_error_ = "The owner of the segment has stopped.";
+  } else if (header->store_offset + ParameterStore::BlockSize(
+      header->nof_parameters) > header->schema_offset ||
+      header->schema_offset + header->schema_size > size) {
+    last_error_ = "The segment layout is invalid.";
+  } else if (!ParseSchema({memory + header->schema_offset,
+                           header->schema_size}, header->nof_parameters)) {
+    last_error_ = "The schema is invalid.";
+  }
+  if (!last_error_.empty()) {
+    Close();
+    return false;
+  }
+
+  // The view never writes, so the read-only mapping is safe.
+  store_ = std::make_unique<ParameterStore>(
+      header->nof_parameters,
+      const_cast<char*>(memory) + header->store_offset);
+  store_->MaxRetries(kMaxReadRetries);
+  return true;
+}
+
+void SharedParameterStore::Close() {
+  store_.reset();
+  schema_.clear();
+  if (region_ && owner_) {
+    auto* header = static_cast<SegmentHeader*>(region_->get_address());
+    header->online.store(0, std::memory_order_release);
+  }
+  region_.reset();
+  if (owner_) {
+    Remove(name_);
+  }
+  owner_ = false;
+}
+
+bool SharedParameterStore::Online() const {
+  if (!region_) {
+    return false;
+  }
+  const auto* header =
+      static_cast<const SegmentHeader*>(region_->get_address());
+  return header->online.load(std::memory_order_acquire) != 0;
+}
+
+const SharedSchemaEntry* SharedParameterStore::Find(
+    const std::string& device, const std::string& name) const {
+  const auto itr = std::ranges::find_if(schema_, [&] (const auto& entry) {
+    return entry.device == device && entry.name == name;
+  });
+  return itr != schema_.cend() ? &(*itr) : nullptr;
+}
+
+bool SharedParameterStore::GetValue(const SharedSchemaEntry& entry,
+                                    double& value) const {
+  if (!store_ || entry.index >= store_->Size() || !Online()) {
+    return false;
+  }
+  uint64_t bits = 0;
+  const bool valid = store_->Load(entry.index, bits);
+  switch (entry.data_type) {
+    case ParameterDataType::FloatType:
+    case ParameterDataType::StringType: // Numeric shadow of the text
+      value = std::bit_cast<double>(bits);
+      break;
+
+    case ParameterDataType::SignedType:
+    case ParameterDataType::EnumType:
+      value = static_cast<double>(std::bit_cast<int64_t>(bits));
+      break;
+
+    case ParameterDataType::UnsignedType:
+    case ParameterDataType::BooleanType:
+      value = static_cast<double>(bits);
+      break;
+
+    case ParameterDataType::ByteArrayType:
+    default:
+      return false;
+  }
+  return valid;
+}
+
+bool SharedParameterStore::Remove(const std::string& name) {
+  return !name.empty() && shared_memory_object::remove(name.c_str());
+}
+
+bool SharedParameterStore::ParseSchema(std::string_view schema,
+                                       size_t nof_parameters) {
+  Parameter temp;
+  while (!schema.empty()) {
+    const auto line_end = schema.find('\n');
+    std::string_view line = schema.substr(0, line_end);
+    schema.remove_prefix(line_end == std::string_view::npos ? schema.size()
+                                                            : line_end + 1);
+    std::vector<std::string_view> field_list;
+    while (true) {
+      const auto tab = line.find('\t');
+      field_list.push_back(line.substr(0, tab));
+      if (tab == std::string_view::npos) {
+        break;
+      }
+      line.remove_prefix(tab + 1);
+    }
+    if (field_list.size() != 5) {
+      return false;
+    }
+
+    SharedSchemaEntry entry;
+    const auto& index = field_list[0];
+    const auto [end, error] = std::from_chars(index.data(),
+                                              index.data() + index.size(),
+                                              entry.index);
+    if (error != std::errc() || entry.index >= nof_parameters) {
+      return false;
+    }
+    entry.device = field_list[1];
+    entry.name = field_list[2];
+    entry.unit = field_list[3];
+    temp.DataTypeAsString(std::string(field_list[4]));
+    entry.data_type = temp.DataType();
+    schema_.push_back(std::move(entry));
+  }
+  return true;
+}
+
+}  // namespace workflow
@@ -10,6 +10,7 @@
 #include <util/stringutil.h>
 #include <util/utilfactory.h>
 #include "workflow/workflow.h"
+#include "workflow/workflowqueue.h"
 
 #include "template_names.icc"
 
@@ -39,10 +40,25 @@ SyslogInput::SyslogInput(const ITask& source)
   ParseArguments();
 }
 
+SyslogInput::SyslogInput(const SyslogInput& source)
+    : ITask(source),
+      address_(source.address_),
+      port_(source.port_),
+      type_(source.type_),
+      queue_name_(source.queue_name_) {
+  // The syslog server is a runtime resource and is created by Init().
+}
+
+std::unique_ptr<ITask> SyslogInput::Clone() const {
+  return std::make_unique<SyslogInput>(*this);
+}
+
 void SyslogInput::Init() {
   ITask::Init();
   ParseArguments();
-  if (IEquals(type_, "TCP")) {
+  if (!queue_name_.empty()) {
+    server_.reset();
+  } else if (IEquals(type_, "TCP")) {
     auto temp = util::UtilFactory::CreateSyslogServer(
         SyslogServerType::TcpServer);
     server_ = std::move(temp);
@@ -52,14 +68,19 @@ void SyslogInput::Init() {
     server_ = std::move(temp);
   }
 
-  server_->Name(Name());
-  server_->Port(port_);
-  server_->Address(address_);
-  server_->Start();
+  if (server_) {
+    server_->Name(Name());
+    server_->Port(port_);
+    server_->Address(address_);
+    server_->Start();
+  }
   auto* workflow = GetWorkflow();
   if (workflow != nullptr) {
-    SyslogList empty_list;
-    workflow->InitData(empty_list);
+    // Keep the messages that the workflow restored from its checkpoint
+    if (workflow->GetData<SyslogList>() == nullptr) {
+      SyslogList empty_list;
+      workflow->InitData(empty_list);
+    }
     IsOk(true);
   } else {
     LastError("Workflow is not attached yet.");
@@ -73,25 +94,47 @@ void SyslogInput::Tick() {
   auto* syslog_list = workflow != nullptr ?
                           workflow->GetData<SyslogList>() :
                           nullptr;
-  if (syslog_list == nullptr || !server_) {
+  if (syslog_list == nullptr) {
     LastError("No syslog list found");
     IsOk(false);
     return;
   }
+  // The queue is looked up on each tick, as it may be deleted meanwhile
+  auto* queue = !queue_name_.empty() ? workflow->GetQueue(queue_name_)
+                                     : nullptr;
+  if (!server_ && queue == nullptr) {
+    LastError("No syslog server or queue found");
+    IsOk(false);
+    return;
+  }
+
+  const bool was_empty = syslog_list->empty();
   syslog_list->clear();
-  for (auto msg = server_->GetMsg(false); msg; msg = server_->GetMsg(false)) {
-    // Insert message into the database
-    syslog_list->emplace_back(*msg);
-    msg.reset();
+  if (queue != nullptr) {
+    for (SyslogMessage msg; queue->Pop(msg); ) {
+      syslog_list->emplace_back(std::move(msg));
+    }
+  } else {
+    for (auto msg = server_->GetMsg(false); msg;
+         msg = server_->GetMsg(false)) {
+      // Insert message into the database
+      syslog_list->emplace_back(*msg);
+      msg.reset();
+    }
+  }
+  if (!was_empty || !syslog_list->empty()) {
+    workflow->DataChanged();
   }
+  IsOk(true);
 }
 
 void SyslogInput::Exit() {
   if (server_) {
     server_->Stop();
   }
+  // The data is kept if the workflow saves it in its checkpoint
   auto* workflow = GetWorkflow();
-  if (workflow != nullptr) {
+  if (workflow != nullptr && workflow->Checkpoint().empty()) {
     workflow->ClearData();
   }
   ITask::Exit();
@@ -109,6 +152,9 @@ void SyslogInput::ParseArguments() {
     desc.add_options() ("type,T",
                        value<std::string>(&type_),
                        "Type of server (UDP, TCP or TLS" );
+    desc.add_options() ("queue,Q",
+                       value<std::string>(&queue_name_)->default_value(""),
+                       "Name of queue to read messages from" );
 
     const auto arg_list = split_unix(Arguments());
     basic_command_line_parser parser(arg_list);
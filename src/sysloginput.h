@@ -10,10 +10,19 @@
 
 namespace workflow {
 
+/**
+ * @brief Receives syslog messages into the workflow data (SyslogList).
+ *
+ * The messages are received by a syslog server. With the '--queue'
+ * argument, the messages are instead popped from a workflow queue that
+ * another workflow pushes to.
+ */
 class SyslogInput : public ITask {
  public:
   SyslogInput();
   explicit SyslogInput(const ITask& source);
+  SyslogInput(const SyslogInput& source);
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override;
   void Init() override;
   void Tick() override;
   void Exit() override;
@@ -22,6 +31,7 @@ class SyslogInput : public ITask {
   std::string address_ = "127.0.0.1"; ///<  0.0.0.0 accept remote connects
   uint16_t port_ = 42514;
   std::string type_ = "UDP"; ///< For future use (UDP/TCP or TLS)
+  std::string queue_name_; ///< Read from a queue instead of a server
 
   std::unique_ptr<util::syslog::ISyslogServer> server_;
 
@@ -15,6 +15,8 @@
 using namespace boost::program_options;
 
 using namespace util::syslog;
+using SyslogList = std::vector<util::syslog::SyslogMessage>;
+
 namespace workflow {
 
 SyslogPublisher::SyslogPublisher() {
@@ -34,6 +36,18 @@ SyslogPublisher::SyslogPublisher(const ITask& source)
   ParseArguments();
 }
 
+SyslogPublisher::SyslogPublisher(const SyslogPublisher& source)
+    : ITask(source),
+      address_(source.address_),
+      port_(source.port_),
+      batch_(source.batch_) {
+  // The syslog server is a runtime resource and is created by Init().
+}
+
+std::unique_ptr<ITask> SyslogPublisher::Clone() const {
+  return std::make_unique<SyslogPublisher>(*this);
+}
+
 void SyslogPublisher::Init() {
   ITask::Init();
   ParseArguments();
@@ -49,8 +63,14 @@ void SyslogPublisher::Init() {
 
   auto* workflow = GetWorkflow();
   if (workflow != nullptr) {
-    const SyslogMessage empty_msg;
-    workflow->InitData(empty_msg);
+    // Keep the data that the workflow restored from its checkpoint
+    if (batch_ && workflow->GetData<SyslogList>() == nullptr) {
+      const SyslogList empty_list;
+      workflow->InitData(empty_list);
+    } else if (!batch_ && workflow->GetData<SyslogMessage>() == nullptr) {
+      const SyslogMessage empty_msg;
+      workflow->InitData(empty_msg);
+    }
     IsOk(true);
   } else {
     LastError("Workflow is not attached yet.");
@@ -64,6 +84,20 @@ void SyslogPublisher::Tick() {
   if (workflow == nullptr) {
     return;
   }
+  if (batch_) {
+    const auto* msg_list = workflow->GetData<SyslogList>();
+    if (msg_list == nullptr || !server_) {
+      LastError("No syslog list found");
+      IsOk(false);
+      return;
+    }
+    for (const auto& msg : *msg_list) {
+      server_->AddMsg(msg);
+    }
+    IsOk(true);
+    return;
+  }
+
   const auto* msg = workflow->GetData<SyslogMessage>();
 
   if (msg == nullptr || !server_) {
@@ -72,14 +106,16 @@ void SyslogPublisher::Tick() {
     return;
   }
   server_->AddMsg(*msg);
+  IsOk(true);
 }
 
 void SyslogPublisher::Exit() {
   if (server_) {
     server_->Stop();
   }
+  // The data is kept if the workflow saves it in its checkpoint
   auto* workflow = GetWorkflow();
-  if (workflow != nullptr) {
+  if (workflow != nullptr && workflow->Checkpoint().empty()) {
     workflow->ClearData();
   }
   ITask::Exit();
@@ -94,6 +130,9 @@ void SyslogPublisher::ParseArguments() {
     desc.add_options() ("port,P",
                        value<uint16_t>(&port_),
                        "Server IP port" );
+    desc.add_options() ("batch,B",
+                       bool_switch(&batch_),
+                       "Publish a list of messages each tick" );
 
     const auto arg_list = split_unix(Arguments());
     basic_command_line_parser parser(arg_list);
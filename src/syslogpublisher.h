@@ -15,6 +15,8 @@ class SyslogPublisher : public ITask {
  public:
   SyslogPublisher();
   explicit SyslogPublisher(const ITask& source);
+  SyslogPublisher(const SyslogPublisher& source);
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override;
   void Init() override;
   void Tick() override;
   void Exit() override;
@@ -22,6 +24,7 @@ class SyslogPublisher : public ITask {
  private:
   std::string address_ = "127.0.0.1"; ///<  0.0.0.0 accept remote connects
   uint16_t port_ = 42515;
+  bool batch_ = false; ///< The workflow data is a list of messages
   std::unique_ptr<util::syslog::ISyslogServer> server_;
 
   void ParseArguments();
@@ -0,0 +1,135 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/watchdog.h"
+#include <algorithm>
+#include <chrono>
+#include <util/logstream.h>
+#include <util/timestamp.h>
+#include "workflow/workflow.h"
+
+using namespace util::time;
+
+namespace {
+
+constexpr size_t kMaxReports = 100; ///< Number of stored stall reports
+
+}
+
+namespace workflow {
+
+Watchdog::~Watchdog() {
+  Watchdog::Stop();
+}
+
+void Watchdog::AttachWorkflow(Workflow* workflow) {
+  if (workflow == nullptr) {
+    return;
+  }
+  // WorkflowServer::Init() may be called more than once
+  std::scoped_lock lock(workflow_lock_);
+  if (std::ranges::find(workflow_list_, workflow) == workflow_list_.cend()) {
+    workflow_list_.emplace_back(workflow);
+  }
+}
+
+void Watchdog::DetachWorkflow(const Workflow* workflow) {
+  // Waits for a running check to finish
+  std::scoped_lock lock(workflow_lock_);
+  std::erase(workflow_list_, workflow);
+}
+
+void Watchdog::DetachWorkflows() {
+  std::scoped_lock lock(workflow_lock_);
+  workflow_list_.clear();
+}
+
+void Watchdog::Start() {
+  Stop();
+  {
+    std::scoped_lock lock(stop_lock_);
+    stop_thread_ = false;
+  }
+  working_thread_ = std::thread(&Watchdog::WatchdogTask, this);
+}
+
+void Watchdog::Stop() {
+  {
+    std::scoped_lock lock(stop_lock_);
+    stop_thread_ = true;
+    stop_condition_.notify_all();
+  }
+  if (working_thread_.joinable()) {
+    working_thread_.join();
+  }
+}
+
+size_t Watchdog::Check(uint64_t now) {
+  size_t count = 0;
+  std::scoped_lock lock(workflow_lock_);
+  for (auto* workflow : workflow_list_) {
+    if (workflow != nullptr) {
+      CheckWorkflow(*workflow, now, count);
+    }
+  }
+  return count;
+}
+
+void Watchdog::CheckWorkflow(Workflow& workflow, uint64_t now,
+                             size_t& count) {
+  // The visit locks the task list and the pool of the workflow, so they
+  // are not deleted by another thread during the check.
+  workflow.VisitTasks([&] (Workflow& owner, ITask& task) {
+    if (!task.CheckTimeout(now)) {
+      return;
+    }
+    ++count;
+    StallReport report;
+    report.workflow = owner.Name();
+    report.instance = owner.InstanceIndex();
+    report.task = task.Name();
+    report.time = TimeStampToNs();
+    report.duration = task.StallDuration();
+    report.thread = task.TickThread();
+
+    LOG_ERROR() << "Task stalled. Workflow: " << report.workflow
+                << ", Instance: " << report.instance
+                << ", Task: " << report.task
+                << ", Duration (ms): " << report.duration / 1'000'000
+                << ", Thread: " << report.thread;
+
+    std::scoped_lock lock(report_lock_);
+    if (report_list_.size() >= kMaxReports) {
+      report_list_.erase(report_list_.begin());
+    }
+    report_list_.emplace_back(std::move(report));
+  });
+}
+
+std::vector<StallReport> Watchdog::Reports() const {
+  std::scoped_lock lock(report_lock_);
+  return report_list_;
+}
+
+void Watchdog::ClearReports() {
+  std::scoped_lock lock(report_lock_);
+  report_list_.clear();
+}
+
+void Watchdog::WatchdogTask() {
+  std::unique_lock lock(stop_lock_);
+  while (!stop_thread_) {
+    stop_condition_.wait_for(lock, std::chrono::milliseconds(period_),
+                             [&] { return stop_thread_; });
+    if (stop_thread_) {
+      break;
+    }
+    lock.unlock();
+    Check(ITask::SteadyTime());
+    lock.lock();
+  }
+}
+
+}  // namespace workflow
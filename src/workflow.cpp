@@ -5,46 +5,77 @@
 
 #include "workflow/workflow.h"
 #include <algorithm>
+#include <array>
+#include <filesystem>
+#include <string_view>
+#include <util/logstream.h>
 #include <util/stringutil.h>
 #include <workflow/workflowserver.h>
+#include "workflow/workflowpool.h"
+#include "workflow/datacheckpoint.h"
 
 using namespace util::xml;
 using namespace util::string;
+
+namespace {
+
+constexpr std::array<std::string_view, 3> kStrandList = {
+    "None", "Serial", "Coalesce"
+};
+
+}
+
 namespace workflow {
 
 Workflow::Workflow(WorkflowServer* server)
   : server_(server) {
 }
 
+Workflow::~Workflow() {
+  std::scoped_lock lock(task_lock_);
+  pool_.reset();
+}
+
 Workflow::Workflow(const Workflow& workflow)
 : name_(workflow.name_),
   description_(workflow.description_),
   start_event_(workflow.start_event_),
+  incremental_(workflow.incremental_),
+  instances_(workflow.instances_),
+  strand_(workflow.strand_),
+  checkpoint_(workflow.checkpoint_),
+  checkpoint_period_(workflow.checkpoint_period_),
   server_(workflow.server_) {
   for ( const auto& runner : workflow.task_list_) {
     if (!runner) {
       continue;
     }
-    auto temp = std::make_unique<ITask>(*runner);
-    task_list_.push_back(std::move(temp));
+    task_list_.push_back(runner->Clone());
   }
+  BuildIndex();
 }
 
 Workflow& Workflow::operator=(const Workflow& workflow) {
   if (this == & workflow) {
     return *this;
   }
+  std::scoped_lock lock(task_lock_);
   name_ = workflow.name_;
   description_ = workflow.description_;
   start_event_ = workflow.start_event_;
+  incremental_ = workflow.incremental_;
+  instances_ = workflow.instances_;
+  strand_ = workflow.strand_;
+  checkpoint_ = workflow.checkpoint_;
+  checkpoint_period_ = workflow.checkpoint_period_;
   task_list_.clear();
   for (const auto& task : workflow.task_list_) {
     if (!task) {
       continue;
     }
-    auto temp = std::make_unique<ITask>(*task);
-    task_list_.push_back(std::move(temp));
+    task_list_.push_back(task->Clone());
   }
+  BuildIndex();
   return *this;
 }
 
@@ -52,6 +83,11 @@ bool Workflow::operator==(const Workflow& workflow) const {
   if (name_ != workflow.name_) return false;
   if (description_ != workflow.description_) return false;
   if (start_event_ != workflow.start_event_) return false;
+  if (incremental_ != workflow.incremental_) return false;
+  if (instances_ != workflow.instances_) return false;
+  if (strand_ != workflow.strand_) return false;
+  if (checkpoint_ != workflow.checkpoint_) return false;
+  if (checkpoint_period_ != workflow.checkpoint_period_) return false;
   const auto task_equal =
       std::ranges::equal(task_list_, workflow.task_list_,
     [] (const auto& task1, const auto& task2) {
@@ -66,17 +102,21 @@ void Workflow::OnStart() {
 }
 
 void Workflow::AddTask(const ITask& task) {
+  std::scoped_lock lock(task_lock_);
   auto temp = server_ != nullptr ? server_->CreateRunner(task) :
                                   std::make_unique<ITask>(task);
   task_list_.emplace_back(std::move(temp));
+  BuildIndex();
 }
 
 void Workflow::DeleteTask(const ITask* task) {
+  std::scoped_lock lock(task_lock_);
   auto itr = std::ranges::find_if(task_list_, [&] (const auto& item) {
     return item && item.get() == task;
   });
   if (itr != task_list_.end()) {
     task_list_.erase(itr);
+    BuildIndex();
   }
 }
 
@@ -87,6 +127,11 @@ void Workflow::SaveXml(IXmlNode& root) const {
   workflow_root.SetProperty("Name", name_);
   workflow_root.SetProperty("Description", description_);
   workflow_root.SetProperty("StartEvent", start_event_);
+  workflow_root.SetProperty("Incremental", incremental_);
+  workflow_root.SetProperty("Instances", instances_);
+  workflow_root.SetProperty("Strand", StrandAsString());
+  workflow_root.SetProperty("Checkpoint", checkpoint_);
+  workflow_root.SetProperty("CheckpointPeriod", checkpoint_period_);
 
   auto& task_root = workflow_root.AddNode("TaskList");
   for (const auto& runner : task_list_) {
@@ -99,7 +144,13 @@ void Workflow::ReadXml(const IXmlNode& root) {
   name_ = root.Property<std::string>("Name");
   description_ = root.Property<std::string>("Description");
   start_event_ = root.Property<std::string>("StartEvent");
+  incremental_ = root.Property<bool>("Incremental", false);
+  instances_ = root.Property<size_t>("Instances", 1);
+  StrandAsString(root.Property<std::string>("Strand", "None"));
+  checkpoint_ = root.Property<std::string>("Checkpoint");
+  checkpoint_period_ = root.Property<uint64_t>("CheckpointPeriod", 0);
 
+  std::scoped_lock lock(task_lock_);
   task_list_.clear();
   // Check for old name runners
   const auto* runner_root = root.GetNode("RunnerList");
@@ -129,24 +180,68 @@ void Workflow::ReadXml(const IXmlNode& root) {
       task_list_.push_back(std::move(task));
     }
   }
-
+  BuildIndex();
 }
 
 const ITask* Workflow::GetTask(const std::string& name) const {
+  const size_t index = FindTask(name);
+  return index < task_list_.size() ? task_list_[index].get() : nullptr;
+}
+
+ITask* Workflow::GetTask(const std::string& name) {
+  const size_t index = FindTask(name);
+  return index < task_list_.size() ? task_list_[index].get() : nullptr;
+}
+
+void Workflow::BuildIndex() {
+  task_index_.Clear();
+  template_index_.Clear();
+  for (size_t index = 0; index < task_list_.size(); ++index) {
+    if (const auto& task = task_list_[index]; task) {
+      task_index_.Add(task->Name(), index);
+      template_index_.Add(task->Template(), index);
+    }
+  }
+}
+
+size_t Workflow::FindTask(const std::string& name) const {
+  // A hit is verified as the task may have been renamed. A miss is final
+  // unless a name or the task list has changed since the index was built.
+  const size_t index = task_index_.Find(name);
+  if (index < task_list_.size() && task_list_[index] &&
+      IEquals(name, task_list_[index]->Name())) {
+    return index;
+  }
+  if (!task_index_.Stale()) {
+    return NameIndex::kNotFound;
+  }
   const auto itr = std::ranges::find_if(task_list_, [&] (const auto& task) {
     return task && IEquals(name, task->Name());
   });
-  return itr == task_list_.cend() ? nullptr : itr->get();
+  return itr != task_list_.cend() ?
+      static_cast<size_t>(std::distance(task_list_.cbegin(), itr)) :
+      NameIndex::kNotFound;
 }
 
-ITask* Workflow::GetTask(const std::string& name) {
-  auto itr = std::ranges::find_if(task_list_, [&] (const auto& task) {
-    return task && IEquals(name, task->Name());
+size_t Workflow::FindTemplate(const std::string& name) const {
+  const size_t index = template_index_.Find(name);
+  if (index < task_list_.size() && task_list_[index] &&
+      IEquals(name, task_list_[index]->Template())) {
+    return index;
+  }
+  if (!template_index_.Stale()) {
+    return NameIndex::kNotFound;
+  }
+  const auto itr = std::ranges::find_if(task_list_, [&] (const auto& task) {
+    return task && IEquals(name, task->Template());
   });
-  return itr == task_list_.end() ? nullptr : itr->get();
+  return itr != task_list_.cend() ?
+      static_cast<size_t>(std::distance(task_list_.cbegin(), itr)) :
+      NameIndex::kNotFound;
 }
 
 void Workflow::MoveUp(const ITask* task) {
+  std::scoped_lock lock(task_lock_);
   if (task == nullptr || task_list_.size() <= 1) {
     return;
   }
@@ -162,9 +257,11 @@ void Workflow::MoveUp(const ITask* task) {
   auto temp = std::move(*prev);
   *prev = std::move(*itr);
   *itr = std::move(temp);
+  BuildIndex();
 }
 
 void Workflow::MoveDown(const ITask* task) {
+  std::scoped_lock lock(task_lock_);
   if (task == nullptr || task_list_.size() <= 1) {
     return;
   }
@@ -183,46 +280,296 @@ void Workflow::MoveDown(const ITask* task) {
   auto temp = std::move(*next);
   *next = std::move(*itr);
   *itr = std::move(temp);
+  BuildIndex();
 }
 void Workflow::Init() {
+  BuildIndex();
+  if (!checkpoint_.empty() && !data_.has_value()) {
+    RestoreCheckpoint();
+  }
+  last_checkpoint_ = ITask::SteadyTime();
+
   // Attach the runner to the workflow, so it can access workflow data
   for (const auto& itr : task_list_) {
     if (!itr) continue;
     itr->AttachWorkflow(this);
   }
+
+  if (instances_ > 1 && !pool_) {
+    auto pool = std::make_unique<WorkflowPool>();
+    pool->Create(*this, instances_);
+    pool->Init();
+    std::scoped_lock lock(task_lock_);
+    pool_ = std::move(pool);
+  }
 }
 
 void Workflow::Tick() {
+  if (strand_ == StrandPolicy::None) {
+    TickTasks();
+    return;
+  }
+
+  ++nof_triggers_;
+  if (pending_.fetch_add(1) > 0) {
+    // Another thread is ticking. That thread runs this tick as well.
+    return;
+  }
+  RunStrand();
+}
+
+void Workflow::Tick(DataUpdate update) {
+  if (strand_ == StrandPolicy::None) {
+    if (update) {
+      update(*this);
+    }
+    TickTasks();
+    return;
+  }
+
+  ++nof_triggers_;
+  bool run = false;
+  {
+    // The update and its tick are queued at the same time, so the pending
+    // ticks are always at least the number of queued updates.
+    std::scoped_lock lock(update_lock_);
+    update_list_.emplace_back(std::move(update));
+    run = pending_.fetch_add(1) == 0;
+  }
+  if (run) {
+    RunStrand();
+  }
+}
+
+void Workflow::RunStrand() {
+  uint64_t pending = 1;
+  while (pending > 0) {
+    DataUpdate update;
+    uint64_t covered = 1;
+    {
+      std::scoped_lock lock(update_lock_);
+      if (!update_list_.empty()) {
+        update = std::move(update_list_.front());
+        update_list_.pop_front();
+      } else if (strand_ == StrandPolicy::Coalesce) {
+        covered = pending_.load();
+      }
+    }
+    nof_coalesced_ += covered - 1;
+    if (update) {
+      update(*this);
+    }
+    TickTasks();
+    pending = pending_.fetch_sub(covered) - covered;
+  }
+}
+
+void Workflow::TickTasks() {
+  if (pool_) {
+    pool_->Tick();
+    return;
+  }
   for (const auto& itr : task_list_) {
     if (!itr) continue;
-    itr->Tick();
+    TickTask(*itr);
+  }
+
+  if (checkpoint_period_ > 0 && !checkpoint_.empty()) {
+    const uint64_t now = ITask::SteadyTime();
+    if (now - last_checkpoint_ >= checkpoint_period_ * 1'000'000'000) {
+      SaveCheckpoint();
+    }
+  }
+}
+
+void Workflow::TickTask(ITask& task) {
+  // Skip tasks whose inputs are unchanged since the last successful tick.
+  const bool check_input = incremental_ && task.HasInputs();
+  const uint64_t input_version = check_input ? task.InputVersion() : 0;
+  if (check_input && input_version == task.LastInputVersion()) {
+    ++nof_task_skips_;
+    return;
+  }
+
+  auto& breaker = task.Breaker();
+  const bool watch = task.Timeout() > 0.0;
+  const uint64_t now = breaker.Enabled() || watch ? ITask::SteadyTime() : 0;
+
+  // Skip failing tasks until their backoff time has expired.
+  if (breaker.Enabled() && !breaker.AllowTick(now)) {
+    return;
+  }
+
+  if (watch) {
+    task.TickStarted(now);
+  }
+  task.Tick();
+  if (watch) {
+    task.TickStopped(ITask::SteadyTime());
+  }
+
+  if (breaker.Enabled()) {
+    if (task.IsOk()) {
+      breaker.Success(now);
+    } else {
+      breaker.Failure(now);
+    }
+  }
+  ++nof_task_runs_;
+
+  if (check_input) {
+    task.LastInputVersion(task.IsOk() ? input_version : ITask::kNoInputVersion);
   }
 }
 
 void Workflow::Exit() {
+  if (!checkpoint_.empty()) {
+    SaveCheckpoint();
+  }
+  // The pool is detached before it is deleted, so the watchdog doesn't
+  // access it meanwhile.
+  std::unique_ptr<WorkflowPool> pool;
+  {
+    std::scoped_lock lock(task_lock_);
+    pool = std::move(pool_);
+  }
+  if (pool) {
+    pool->Exit();
+    pool.reset();
+  }
   for (const auto& itr : task_list_) {
     if (!itr) continue;
     itr->AttachWorkflow(nullptr);
   }
 }
 
+bool Workflow::SaveCheckpoint() {
+  last_checkpoint_ = ITask::SteadyTime();
+  const auto& checkpoint = DataCheckpoint::Instance();
+  if (checkpoint_.empty() || !checkpoint.IsRegistered(data_)) {
+    return false;
+  }
+  std::string error;
+  const bool save = checkpoint.Save(data_, checkpoint_, error);
+  if (!save) {
+    LOG_ERROR() << "Failed to save checkpoint. Workflow: " << name_
+                << ", Error: " << error;
+  }
+  return save;
+}
+
+bool Workflow::RestoreCheckpoint() {
+  std::error_code err;
+  if (checkpoint_.empty() || !std::filesystem::exists(checkpoint_, err)) {
+    return false;
+  }
+  std::string error;
+  const bool restore = DataCheckpoint::Instance().Restore(checkpoint_, data_,
+                                                          error);
+  if (!restore) {
+    LOG_ERROR() << "Failed to restore checkpoint. Workflow: " << name_
+                << ", Error: " << error;
+    return false;
+  }
+  DataChanged();
+  return true;
+}
+
 void Workflow::ClearData() {
   data_.reset();
+  DataChanged();
+}
+
+bool Workflow::Stalled() const {
+  std::scoped_lock lock(task_lock_);
+  const bool stalled = std::ranges::any_of(task_list_, [] (const auto& task) {
+    return task && task->Stalled();
+  });
+  if (stalled || !pool_) {
+    return stalled;
+  }
+  for (size_t index = 0; index < pool_->Size(); ++index) {
+    const auto* instance = pool_->Instance(index);
+    if (instance != nullptr && instance->Stalled()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Workflow::VisitTasks(const TaskVisitor& visitor) {
+  std::scoped_lock lock(task_lock_);
+  for (auto& task : task_list_) {
+    if (task) {
+      visitor(*this, *task);
+    }
+  }
+  if (!pool_) {
+    return;
+  }
+  for (size_t index = 0; index < pool_->Size(); ++index) {
+    if (auto* instance = pool_->Instance(index); instance != nullptr) {
+      instance->VisitTasks(visitor);
+    }
+  }
+}
+
+void Workflow::ResetStatistics() {
+  nof_task_runs_ = 0;
+  nof_task_skips_ = 0;
+  nof_triggers_ = 0;
+  nof_coalesced_ = 0;
+}
+
+void Workflow::StrandAsString(const std::string& policy) {
+  for (size_t index = 0; index < kStrandList.size(); ++index) {
+    if (IEquals(policy, kStrandList[index].data())) {
+      strand_ = static_cast<StrandPolicy>(index);
+      return;
+    }
+  }
+}
+
+std::string Workflow::StrandAsString() const {
+  const auto index = static_cast<size_t>(strand_);
+  return index < kStrandList.size() ? std::string(kStrandList[index])
+                                    : std::string();
+}
+
+Workflow* Workflow::SelectInstance(const std::string& key) {
+  return pool_ ? pool_->Select(key) : this;
+}
+
+std::unique_ptr<Workflow> Workflow::CreateInstance(size_t index) const {
+  // The tasks are cloned, so each instance gets its own task objects of
+  // the same type as the definition. Use a WorkflowPrototype if the
+  // definition holds plain task templates.
+  auto instance = std::make_unique<Workflow>(server_);
+  instance->name_ = name_;
+  instance->description_ = description_;
+  instance->incremental_ = incremental_;
+  instance->instance_index_ = index;
+  for (const auto& task : task_list_) {
+    if (task) {
+      instance->task_list_.push_back(task->Clone());
+    }
+  }
+  instance->BuildIndex();
+  return instance;
 }
 
 Workflow* Workflow::GetWorkflow(const std::string& schedule_name) {
   return server_ != nullptr ? server_->GetWorkflow(schedule_name) : nullptr;
 }
 
+WorkflowQueue* Workflow::GetQueue(const std::string& queue_name) {
+  return server_ != nullptr ? server_->GetQueue(queue_name) : nullptr;
+}
+
 const ITask* Workflow::GetTaskByTemplateName(
     const std::string& name) const {
-  const auto itr = std::ranges::find_if(task_list_, [&] (const auto& task) {
-    return task && IEquals(name, task->Template());
-  });
-  if (itr != task_list_.cend()) {
-    return itr->get();
-  }
-  return nullptr;
+  const size_t index = FindTemplate(name);
+  return index < task_list_.size() ? task_list_[index].get() : nullptr;
 }
 
 }  // namespace workflow
\ No newline at end of file
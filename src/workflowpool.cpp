@@ -0,0 +1,161 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/workflowpool.h"
+#include <utility>
+#include "workflow/workflowprototype.h"
+
+namespace workflow {
+
+WorkflowPool::~WorkflowPool() {
+  WorkflowPool::Exit();
+}
+
+void WorkflowPool::Create(const Workflow& definition, size_t nof_instances) {
+  Exit();
+  instance_list_.clear();
+  const WorkflowPrototype prototype(definition);
+  for (size_t index = 0; index < nof_instances; ++index) {
+    instance_list_.emplace_back(prototype.Instantiate(index));
+  }
+}
+
+Workflow* WorkflowPool::Instance(size_t index) {
+  return index < instance_list_.size() ? instance_list_[index].get()
+                                       : nullptr;
+}
+
+void WorkflowPool::SetPartitionFunction(PartitionFunction function) {
+  partition_function_ = std::move(function);
+}
+
+size_t WorkflowPool::Partition(const std::string& key) const {
+  const size_t nof_instances = instance_list_.size();
+  if (nof_instances <= 1) {
+    return 0;
+  }
+  const size_t index = partition_function_ ?
+                       partition_function_(key, nof_instances) :
+                       std::hash<std::string>{}(key);
+  return index % nof_instances;
+}
+
+Workflow* WorkflowPool::Select(const std::string& key) {
+  return Instance(Partition(key));
+}
+
+void WorkflowPool::Run(const InstanceJob& job) {
+  std::scoped_lock run_lock(run_lock_);
+  if (thread_list_.empty()) {
+    // Not started. Run the job in the caller thread.
+    for (size_t index = 0; index < instance_list_.size(); ++index) {
+      if (instance_list_[index]) {
+        job(*instance_list_[index], index);
+      }
+    }
+    return;
+  }
+
+  std::unique_lock lock(job_lock_);
+  job_ = &job;
+  nof_running_ = thread_list_.size();
+  ++job_id_;
+  job_condition_.notify_all();
+  done_condition_.wait(lock, [&] { return nof_running_ == 0; });
+  job_ = nullptr;
+}
+
+void WorkflowPool::Init() {
+  if (!init_) {
+    // Each instance owns its tasks, so the tasks are initialized here. The
+    // task Init() typically creates the instance workflow data.
+    for (auto& instance : instance_list_) {
+      if (!instance) {
+        continue;
+      }
+      instance->Init();
+      for (const auto& task : std::as_const(*instance).Tasks()) {
+        if (task) {
+          task->Init();
+        }
+      }
+    }
+    init_ = true;
+  }
+
+  if (!thread_list_.empty()) {
+    return;
+  }
+  std::scoped_lock lock(job_lock_);
+  stop_thread_ = false;
+  for (size_t index = 0; index < instance_list_.size(); ++index) {
+    thread_list_.emplace_back(&WorkflowPool::WorkerTask, this, index, job_id_);
+  }
+}
+
+void WorkflowPool::Tick() {
+  Run([] (Workflow& instance, size_t) {
+    instance.Tick();
+  });
+}
+
+void WorkflowPool::Exit() {
+  std::scoped_lock run_lock(run_lock_);
+  {
+    std::scoped_lock lock(job_lock_);
+    stop_thread_ = true;
+    job_condition_.notify_all();
+  }
+  for (auto& thread : thread_list_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  thread_list_.clear();
+
+  if (!init_) {
+    return;
+  }
+  init_ = false;
+  for (auto& instance : instance_list_) {
+    if (!instance) {
+      continue;
+    }
+    for (const auto& task : std::as_const(*instance).Tasks()) {
+      if (task) {
+        task->Exit();
+      }
+    }
+    instance->Exit();
+  }
+}
+
+void WorkflowPool::WorkerTask(size_t index, uint64_t last_job) {
+  std::unique_lock lock(job_lock_);
+  while (true) {
+    job_condition_.wait(lock, [&] {
+      return stop_thread_ || job_id_ != last_job;
+    });
+    if (stop_thread_) {
+      break;
+    }
+    last_job = job_id_;
+    const auto* job = job_;
+    auto* instance = Instance(index);
+
+    lock.unlock();
+    if (job != nullptr && instance != nullptr) {
+      (*job)(*instance, index);
+    }
+    lock.lock();
+
+    --nof_running_;
+    if (nof_running_ == 0) {
+      done_condition_.notify_all();
+    }
+  }
+}
+
+}  // namespace workflow
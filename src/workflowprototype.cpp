@@ -0,0 +1,34 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/workflowprototype.h"
+#include <typeinfo>
+#include "workflow/workflowserver.h"
+
+namespace workflow {
+
+WorkflowPrototype::WorkflowPrototype(const Workflow& definition)
+: definition_(std::make_unique<Workflow>(definition)) {
+  const auto* server = definition.GetServer();
+  if (server == nullptr) {
+    return;
+  }
+  for (auto& task : definition_->Tasks()) {
+    // Only plain task templates needs to be created by a factory.
+    if (!task || typeid(*task) != typeid(ITask)) {
+      continue;
+    }
+    auto compiled = server->CreateRunner(*task);
+    if (compiled) {
+      task = std::move(compiled);
+    }
+  }
+}
+
+std::unique_ptr<Workflow> WorkflowPrototype::Instantiate(size_t index) const {
+  return definition_->CreateInstance(index);
+}
+
+}  // namespace workflow
@@ -0,0 +1,247 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include "workflow/workflowqueue.h"
+#include <array>
+#include <string_view>
+#include <thread>
+#include <util/ixmlnode.h>
+#include <util/stringutil.h>
+
+using namespace util::xml;
+
+namespace {
+
+constexpr std::array<std::string_view, 3> kPolicyList = {
+    "DropNewest", "DropOldest", "Block"
+};
+
+}
+
+namespace workflow {
+
+WorkflowQueue::WorkflowQueue(const WorkflowQueue& queue)
+: name_(queue.name_),
+  description_(queue.description_),
+  capacity_(queue.capacity_),
+  policy_(queue.policy_) {
+}
+
+bool WorkflowQueue::operator==(const WorkflowQueue& queue) const {
+  if (name_ != queue.name_) return false;
+  if (description_ != queue.description_) return false;
+  if (capacity_ != queue.capacity_) return false;
+  if (policy_ != queue.policy_) return false;
+  return true;
+}
+
+void WorkflowQueue::PolicyAsString(const std::string& policy) {
+  for (size_t index = 0; index < kPolicyList.size(); ++index) {
+    if (util::string::IEquals(policy, kPolicyList[index].data())) {
+      policy_ = static_cast<DropPolicy>(index);
+      return;
+    }
+  }
+}
+
+std::string WorkflowQueue::PolicyAsString() const {
+  const auto index = static_cast<size_t>(policy_);
+  return index < kPolicyList.size() ? std::string(kPolicyList[index])
+                                    : std::string();
+}
+
+bool WorkflowQueue::Push(std::any&& item) {
+  if (!active_) {
+    ++nof_dropped_;
+    return false;
+  }
+
+  while (!TryPush(item)) {
+    switch (policy_) {
+      case DropPolicy::DropOldest: {
+        std::any oldest;
+        if (TryPop(oldest)) {
+          ++nof_dropped_;
+        }
+        break;
+      }
+
+      case DropPolicy::Block: {
+        // The pop counter is read before the depth, so a pop in between
+        // isn't missed. Exit() also steps the counter.
+        const uint64_t pop_signal = pop_signal_;
+        if (!active_) {
+          ++nof_dropped_;
+          return false;
+        }
+        if (Depth() >= capacity_) {
+          ++nof_blocked_;
+          pop_signal_.wait(pop_signal);
+          --nof_blocked_;
+        } else {
+          std::this_thread::yield(); // A pop is in progress
+        }
+        break;
+      }
+
+      case DropPolicy::DropNewest:
+      default:
+        ++nof_dropped_;
+        return false;
+    }
+  }
+  ++nof_pushed_;
+
+  const size_t depth = Depth();
+  size_t max_depth = max_depth_;
+  while (depth > max_depth &&
+         !max_depth_.compare_exchange_weak(max_depth, depth)) {
+  }
+
+  // Only wake the consumer if it is waiting. This keeps the producer free
+  // from system calls when the consumer is busy.
+  ++signal_;
+  if (waiting_) {
+    signal_.notify_one();
+  }
+  return true;
+}
+
+bool WorkflowQueue::Pop(std::any& item) {
+  if (!cell_list_ || !TryPop(item)) {
+    return false;
+  }
+  ++nof_popped_;
+
+  // Only wake producers that are blocked on a full queue
+  ++pop_signal_;
+  if (nof_blocked_ > 0) {
+    pop_signal_.notify_all();
+  }
+  return true;
+}
+
+size_t WorkflowQueue::Depth() const {
+  const size_t read_pos = read_pos_;
+  const size_t write_pos = write_pos_;
+  return write_pos > read_pos ? write_pos - read_pos : 0;
+}
+
+void WorkflowQueue::ResetStatistics() {
+  max_depth_ = Depth();
+  nof_pushed_ = 0;
+  nof_popped_ = 0;
+  nof_dropped_ = 0;
+}
+
+bool WorkflowQueue::WaitForItems(const std::atomic<bool>& cancel,
+                                 uint64_t& signal) {
+  waiting_ = true;
+  while (signal_ == signal && !cancel) {
+    signal_.wait(signal);
+  }
+  waiting_ = false;
+  signal = signal_;
+  return !Empty();
+}
+
+void WorkflowQueue::Wake() {
+  ++signal_;
+  signal_.notify_all();
+}
+
+void WorkflowQueue::Init() {
+  active_ = false;
+  if (capacity_ == 0) {
+    capacity_ = 1;
+  }
+  size_t size = 2;
+  while (size < capacity_) {
+    size <<= 1;
+  }
+  cell_list_ = std::make_unique<Cell[]>(size);
+  for (size_t index = 0; index < size; ++index) {
+    cell_list_[index].sequence = index;
+  }
+  mask_ = size - 1;
+  write_pos_ = 0;
+  read_pos_ = 0;
+  ResetStatistics();
+  active_ = true;
+}
+
+void WorkflowQueue::Exit() {
+  active_ = false;
+  Wake();
+  ++pop_signal_;
+  pop_signal_.notify_all();
+}
+
+void WorkflowQueue::SaveXml(IXmlNode& root) const {
+  auto& queue_root = root.AddNode("Queue");
+  queue_root.SetAttribute("name", name_);
+  queue_root.SetProperty("Name", name_);
+  queue_root.SetProperty("Description", description_);
+  queue_root.SetProperty("Capacity", capacity_);
+  queue_root.SetProperty("DropPolicy", PolicyAsString());
+}
+
+void WorkflowQueue::ReadXml(const IXmlNode& root) {
+  name_ = root.Property<std::string>("Name");
+  description_ = root.Property<std::string>("Description");
+  capacity_ = root.Property<size_t>("Capacity", 1024);
+  PolicyAsString(root.Property<std::string>("DropPolicy", "DropNewest"));
+}
+
+bool WorkflowQueue::TryPush(std::any& item) {
+  size_t pos = write_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    auto& cell = cell_list_[pos & mask_];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<intptr_t>(sequence) -
+                      static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      const size_t read_pos = read_pos_.load(std::memory_order_acquire);
+      if (pos >= read_pos && pos - read_pos >= capacity_) {
+        return false; // Full
+      }
+      if (write_pos_.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+        cell.item = std::move(item);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false; // Full
+    } else {
+      pos = write_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool WorkflowQueue::TryPop(std::any& item) {
+  size_t pos = read_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    auto& cell = cell_list_[pos & mask_];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<intptr_t>(sequence) -
+                      static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (read_pos_.compare_exchange_weak(pos, pos + 1,
+                                          std::memory_order_relaxed)) {
+        item = std::move(cell.item);
+        cell.item.reset();
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false; // Empty
+    } else {
+      pos = read_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace workflow
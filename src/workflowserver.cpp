@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <vector>
 #include <memory>
+#include <utility>
 #include <sstream>
 #include <util/stringutil.h>
+#include <util/logstream.h>
 #include "defaulttemplatefactory.h"
 
 using namespace util::xml;
@@ -47,6 +49,17 @@ bool WorkflowServer::operator==(const WorkflowServer& server) const {
     }
   }
 
+  const auto queue_equal = std::ranges::equal(
+      queue_list_, server.queue_list_,
+      [] (const auto& queue1, const auto& queue2) {
+        if (!queue1.second && !queue2.second) return true;
+        return queue1.second && queue2.second &&
+               (*queue1.second == *queue2.second);
+      });
+  if (!queue_equal) {
+    return false;
+  }
+
   const auto workflow_equal = std::ranges::equal(
       workflow_list_, server.workflow_list_,
       [] (const auto& workflow1, const auto& workflow2) {
@@ -68,6 +81,15 @@ bool WorkflowServer::operator==(const WorkflowServer& server) const {
   return true;
 }
 
+void WorkflowServer::ArenaMode(bool arena_mode) {
+  if (arena_mode && !arena_) {
+    arena_ = std::make_unique<ConfigArena>();
+  } else if (!arena_mode && arena_ && arena_->NofObjects() == 0) {
+    // The arena is kept until its objects are deleted.
+    arena_.reset();
+  }
+}
+
 void WorkflowServer::SetParameterContainer(
     std::unique_ptr<ParameterContainer>& parameters) {
   parameter_container_ = std::move(parameters);
@@ -101,7 +123,9 @@ void WorkflowServer::AddWorkflow(const Workflow& workflow) {
   });
   if (itr == workflow_list_.end()) {
     workflow_list_.emplace_back(std::move(temp));
+    workflow_index_.Add(workflow.Name(), workflow_list_.size() - 1);
   } else {
+    watchdog_.DetachWorkflow(itr->get());
     *itr = std::move(temp);
   }
 }
@@ -111,24 +135,76 @@ void WorkflowServer::DeleteWorkflow(const Workflow* workflow) {
     return item.get() == workflow;
   });
   if (itr != workflow_list_.end()) {
+    watchdog_.DetachWorkflow(itr->get());
     workflow_list_.erase(itr);
+    BuildIndex();
   }
 }
 
 const Workflow* WorkflowServer::GetWorkflow(const std::string& name) const {
-  const auto itr = std::ranges::find_if(workflow_list_,
-        [&] (const auto& workflow) {
-        return workflow && IEquals(name, workflow->Name()); });
-  return itr != workflow_list_.cend() ? itr->get() : nullptr;
+  const size_t index = FindWorkflow(name);
+  return index < workflow_list_.size() ? workflow_list_[index].get()
+                                       : nullptr;
 }
 
 Workflow* WorkflowServer::GetWorkflow(const std::string& name) {
-  auto itr = std::ranges::find_if(workflow_list_,
+  const size_t index = FindWorkflow(name);
+  return index < workflow_list_.size() ? workflow_list_[index].get()
+                                       : nullptr;
+}
+
+void WorkflowServer::BuildIndex() {
+  workflow_index_.Clear();
+  for (size_t index = 0; index < workflow_list_.size(); ++index) {
+    if (const auto& workflow = workflow_list_[index]; workflow) {
+      workflow_index_.Add(workflow->Name(), index);
+    }
+  }
+}
+
+size_t WorkflowServer::FindWorkflow(const std::string& name) const {
+  // A hit is verified as the workflow may have been renamed. A miss is final
+  // unless a name or the workflow list has changed since the index was built.
+  const size_t index = workflow_index_.Find(name);
+  if (index < workflow_list_.size() && workflow_list_[index] &&
+      IEquals(name, workflow_list_[index]->Name())) {
+    return index;
+  }
+  if (!workflow_index_.Stale()) {
+    return NameIndex::kNotFound;
+  }
+  const auto itr = std::ranges::find_if(workflow_list_,
                                         [&] (const auto& workflow) {
-                                          return workflow && IEquals(name, workflow->Name()); });
-  return itr != workflow_list_.end() ? itr->get() : nullptr;
+    return workflow && IEquals(name, workflow->Name());
+  });
+  return itr != workflow_list_.cend() ?
+      static_cast<size_t>(std::distance(workflow_list_.cbegin(), itr)) :
+      NameIndex::kNotFound;
+}
+
+void WorkflowServer::AddQueue(const WorkflowQueue& queue) {
+  auto temp = std::make_unique<WorkflowQueue>(queue);
+  queue_list_.insert_or_assign(queue.Name(), std::move(temp));
+}
+
+void WorkflowServer::DeleteQueue(const WorkflowQueue* queue) {
+  auto itr = std::ranges::find_if(queue_list_, [&] (const auto& item) {
+    return item.second.get() == queue;
+  });
+  if (itr != queue_list_.end()) {
+    queue_list_.erase(itr);
+  }
+}
+
+const WorkflowQueue* WorkflowServer::GetQueue(const std::string& name) const {
+  const auto itr = queue_list_.find(name);
+  return itr != queue_list_.cend() ? itr->second.get() : nullptr;
 }
 
+WorkflowQueue* WorkflowServer::GetQueue(const std::string& name) {
+  auto itr = queue_list_.find(name);
+  return itr != queue_list_.end() ? itr->second.get() : nullptr;
+}
 
 std::map<std::string, const ITask*> WorkflowServer::Templates() const {
   std::map<std::string, const ITask*> template_list;
@@ -154,6 +230,8 @@ const ITask* WorkflowServer::GetTemplate(const std::string& name) const {
 }
 
 void WorkflowServer::Init() {
+  bool watch = false;
+  BuildIndex();
 
   // Associate the event with its workflow
   for (auto& workflow : workflow_list_) {
@@ -161,6 +239,12 @@ void WorkflowServer::Init() {
       continue;
     }
 
+    // Only start the watchdog if any task has a timeout
+    watchdog_.AttachWorkflow(workflow.get());
+    watch |= std::ranges::any_of(std::as_const(*workflow).Tasks(),
+                                 [] (const auto& task) {
+      return task && task->Timeout() > 0.0;
+    });
 
     const auto& event_name = workflow->StartEvent();
     auto* event = event_engine_->GetEvent(event_name);
@@ -174,7 +258,23 @@ void WorkflowServer::Init() {
     parameter_container_->Init();
   }
 
+  if (watch) {
+    watchdog_.Start();
+  }
+
+  // The queues shall be ready before any producer or consumer starts
+  for (auto& [name, queue] : queue_list_) {
+    if (queue) {
+      queue->Init();
+    }
+  }
+
   if (event_engine_) {
+    for (auto& [name, event] : event_engine_->Events()) {
+      if (event && event->Type() == EventType::Queue) {
+        event->AttachQueue(GetQueue(event->Parameter()));
+      }
+    }
     event_engine_->Init();
   }
 }
@@ -189,13 +289,28 @@ void WorkflowServer::Tick() {
 }
 
 void WorkflowServer::Exit() {
+  watchdog_.Stop();
+  watchdog_.DetachWorkflows();
+
   if (parameter_container_) {
     parameter_container_->Exit();
   }
 
+  // Release producers that are blocked on a full queue
+  for (auto& [name, queue] : queue_list_) {
+    if (queue) {
+      queue->Exit();
+    }
+  }
+
   if (event_engine_) {
     event_engine_->Exit();
     event_engine_->DetachWorkflows();
+    for (auto& [name, event] : event_engine_->Events()) {
+      if (event) {
+        event->AttachQueue(nullptr);
+      }
+    }
   }
 
   for (auto& workflow : workflow_list_) {
@@ -247,6 +362,14 @@ void WorkflowServer::SaveXml(IXmlNode& root) const {
     event_engine_->SaveXml(engine_root);
   }
 
+  if (!queue_list_.empty()) {
+    auto& queue_root = engine_root.AddNode("QueueList");
+    for (const auto& [name, queue] : queue_list_) {
+      if (!queue) continue;
+      queue->SaveXml(queue_root);
+    }
+  }
+
   if (!workflow_list_.empty()) {
     auto& workflow_root = engine_root.AddNode("WorkflowList");
     for (const auto& workflow : workflow_list_) {
@@ -299,6 +422,7 @@ void WorkflowServer::ReadXml(const IXmlNode& root) {
   if (engine_root == nullptr) {
     return;
   }
+  ConfigArenaScope arena_scope(arena_.get());
 
   name_ = engine_root->Property<std::string>("Name");
   description_ = engine_root->Property<std::string>("Description");
@@ -309,6 +433,22 @@ void WorkflowServer::ReadXml(const IXmlNode& root) {
     event_engine_->ReadXml(*engine_root);
   }
 
+  queue_list_.clear();
+  const auto* queue_root = engine_root->GetNode("QueueList");
+  if (queue_root != nullptr) {
+    IXmlNode::ChildList list;
+    queue_root->GetChildList(list);
+    for (const auto* queue : list) {
+      if (queue == nullptr || !queue->IsTagName("Queue")) {
+        continue;
+      }
+      WorkflowQueue temp;
+      temp.ReadXml(*queue);
+      AddQueue(temp);
+    }
+  }
+
+  watchdog_.DetachWorkflows();
   workflow_list_.clear();
   const auto* workflow_root = engine_root->GetNode("WorkflowList");
   if (workflow_root != nullptr) {
@@ -323,6 +463,7 @@ void WorkflowServer::ReadXml(const IXmlNode& root) {
       workflow_list_.emplace_back(std::move(flow));
     }
   }
+  BuildIndex();
 }
 
 void WorkflowServer::Clear() {
@@ -334,7 +475,16 @@ void WorkflowServer::Clear() {
   if (event_engine_) {
     event_engine_->Clear();
   }
+  queue_list_.clear();
+  watchdog_.DetachWorkflows();
   workflow_list_.clear();
+  workflow_index_.Clear();
+  // Objects that still live in the arena, keep its memory until the next
+  // Clear().
+  if (arena_ && !arena_->Release()) {
+    LOG_ERROR() << "Failed to release the configuration arena. Objects: "
+                << arena_->NofObjects();
+  }
 }
 
 void WorkflowServer::MoveUp(const Workflow* workflow) {
@@ -353,6 +503,7 @@ void WorkflowServer::MoveUp(const Workflow* workflow) {
   auto temp = std::move(*prev);
   *prev = std::move(*itr);
   *itr = std::move(temp);
+  BuildIndex();
 }
 
 void WorkflowServer::MoveDown(const Workflow* workflow) {
@@ -374,6 +525,7 @@ void WorkflowServer::MoveDown(const Workflow* workflow) {
   auto temp = std::move(*next);
   *next = std::move(*itr);
   *itr = std::move(temp);
+  BuildIndex();
 }
 
 std::unique_ptr<ITask> WorkflowServer::CreateRunner(const ITask &templ) const {
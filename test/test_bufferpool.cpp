@@ -0,0 +1,133 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include "workflow/bufferpool.h"
+#include "workflow/parameter.h"
+
+namespace workflow::test {
+
+TEST(BufferPool, TestReuse) {
+  BufferPool pool(2);
+  EXPECT_EQ(pool.MaxBuffers(), 2);
+  {
+    auto buffer1 = pool.Acquire(100);
+    auto buffer2 = pool.Acquire(1000);
+    auto buffer3 = pool.Acquire(10);
+    EXPECT_EQ(buffer1->size(), 100);
+    EXPECT_EQ(pool.NofAllocations(), 3);
+    EXPECT_EQ(pool.NofFree(), 0);
+    buffer2.reset();
+    buffer1.reset();
+    EXPECT_EQ(pool.NofFree(), 2);
+  }
+  EXPECT_EQ(pool.NofFree(), 2); // The third buffer is freed
+
+  auto buffer = pool.Acquire(50);
+  EXPECT_EQ(pool.NofReuses(), 1);
+  EXPECT_EQ(pool.NofAllocations(), 3);
+  EXPECT_EQ(buffer->size(), 50);
+  EXPECT_EQ(buffer->capacity(), 100); // Smallest buffer that fits
+
+  const uint8_t data[] = {1, 2, 3};
+  SharedBuffer copy;
+  {
+    BufferPool temp_pool;
+    copy = temp_pool.Copy(data, sizeof(data));
+  }
+  // The buffer outlives the pool
+  ASSERT_EQ(copy->size(), 3);
+  EXPECT_EQ((*copy)[2], 3);
+}
+
+TEST(BufferPool, TestZeroCopy) {
+  Parameter par;
+  par.DataType(ParameterDataType::ByteArrayType);
+
+  auto frame = std::make_shared<ByteArray>(1000);
+  std::iota(frame->begin(), frame->end(), 0);
+  const SharedBuffer input = frame;
+  par.SetValue(true, input);
+
+  SharedBuffer output;
+  EXPECT_TRUE(par.GetValue(output));
+  EXPECT_EQ(output.get(), input.get()); // Same buffer
+
+  // The reader keeps its view when the value is set again
+  const ByteArray next = {1, 2, 3};
+  par.SetValue(true, ByteSpan(next));
+  EXPECT_EQ(output->size(), 1000);
+  SharedBuffer next_output;
+  EXPECT_TRUE(par.GetValue(next_output));
+  EXPECT_EQ(*next_output, next);
+
+  ByteArray copy;
+  EXPECT_TRUE(par.GetValue(copy));
+  EXPECT_EQ(copy, next);
+
+  // Other data types are converted
+  Parameter number;
+  number.DataType(ParameterDataType::UnsignedType);
+  number.SetValue(true, input);
+  uint64_t value = 99;
+  EXPECT_TRUE(number.GetValue(value));
+  EXPECT_EQ(value, 0);
+  SharedBuffer number_buffer;
+  EXPECT_TRUE(number.GetValue(number_buffer));
+  EXPECT_EQ(number_buffer->size(), sizeof(uint64_t));
+
+  Parameter text;
+  text.DataType(ParameterDataType::StringType);
+  const std::string input_text = "12.5";
+  text.SetValue(true, ByteSpan(reinterpret_cast<const uint8_t*>(
+      input_text.data()), input_text.size()));
+  double text_value = 0.0;
+  EXPECT_TRUE(text.GetValue(text_value));
+  EXPECT_DOUBLE_EQ(text_value, 12.5);
+}
+
+TEST(BufferPool, TestSpeed) {
+  constexpr size_t kFrameSize = 300'000;
+  constexpr size_t kNofFrames = 500;
+  Parameter par;
+  par.DataType(ParameterDataType::ByteArrayType);
+  const ByteArray frame(kFrameSize, 0x55);
+
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofFrames; ++count) {
+    par.SetValue(true, frame);
+    ByteArray output;
+    [[maybe_unused]] const bool valid = par.GetValue(output);
+    bytes += output.size();
+  }
+  const auto copy = std::chrono::steady_clock::now() - start;
+
+  const auto nof_allocations = BufferPool::Default().NofAllocations();
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofFrames; ++count) {
+    par.SetValue(true, ByteSpan(frame));
+    SharedBuffer output;
+    [[maybe_unused]] const bool valid = par.GetValue(output);
+    bytes -= output->size();
+  }
+  const auto shared = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(bytes, 0);
+  // The frames are recycled by the pool
+  EXPECT_LE(BufferPool::Default().NofAllocations(), nof_allocations + 2);
+
+  const auto per_frame = [&] (auto duration) {
+    return static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration).count()) / kNofFrames / 1000.0;
+  };
+  std::cout << "Frame " << kFrameSize << " bytes (us) Copy set/get: "
+            << per_frame(copy) << ", Pooled set/shared get: "
+            << per_frame(shared) << std::endl;
+}
+
+}  // namespace workflow::test
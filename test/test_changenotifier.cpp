@@ -0,0 +1,212 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "workflow/changenotifier.h"
+#include "workflow/parametercontainer.h"
+#include "workflow/workflowqueue.h"
+
+using namespace std::chrono_literals;
+
+namespace workflow::test {
+
+TEST(ChangeNotifier, TestCoalesce) {
+  ParameterContainer container;
+  std::vector<Parameter*> parameter_list;
+  for (size_t index = 0; index < 100; ++index) {
+    parameter_list.push_back(container.CreateParameter(
+        "Device", "Parameter" + std::to_string(index)));
+  }
+
+  // No subscribers. Nothing shall be queued.
+  parameter_list[0]->SetValue(true, 1.0);
+  container.Tick();
+  EXPECT_EQ(container.Notifier().NofChanges(), 0);
+
+  size_t nof_calls = 0;
+  size_t nof_changed = 0;
+  const auto all = container.Subscribe([&] (const ChangeList& change_list) {
+    ++nof_calls;
+    nof_changed += change_list.size();
+  });
+  EXPECT_GT(all, 0);
+
+  std::vector<double> last_values;
+  const auto single = parameter_list[5]->Subscribe(
+      [&] (const ChangeList& change_list) {
+    ASSERT_EQ(change_list.size(), 1);
+    double value = 0;
+    EXPECT_TRUE(change_list[0]->GetValue(value));
+    last_values.push_back(value);
+  });
+  EXPECT_GT(single, 0);
+
+  // A burst of 10k sets results in one notification per subscriber
+  for (size_t count = 0; count < 10'000; ++count) {
+    parameter_list[count % 100]->SetValue(true, static_cast<double>(count));
+  }
+  EXPECT_EQ(container.Notifier().NofChanges(), 10'000);
+  EXPECT_EQ(nof_calls, 0);
+  container.Tick();
+  EXPECT_EQ(nof_calls, 1);
+  EXPECT_EQ(nof_changed, 100);
+  EXPECT_EQ(last_values, std::vector<double>({9'905.0}));
+  EXPECT_EQ(container.Notifier().NofNotifications(), 2);
+
+  // Nothing changed
+  container.Tick();
+  EXPECT_EQ(nof_calls, 1);
+
+  parameter_list[5]->SetValue(true, 5.0);
+  container.Tick();
+  EXPECT_EQ(nof_calls, 2);
+  EXPECT_EQ(last_values.size(), 2);
+
+  container.Unsubscribe(all);
+  parameter_list[5]->Unsubscribe(single);
+  parameter_list[5]->SetValue(true, 6.0);
+  container.Tick();
+  EXPECT_EQ(nof_calls, 2);
+  EXPECT_EQ(last_values.size(), 2);
+}
+
+TEST(ChangeNotifier, TestQueueDelivery) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* gear = container.CreateParameter("Car", "Gear");
+
+  WorkflowQueue queue;
+  queue.Init();
+  container.Subscribe(queue, {gear});
+
+  speed->SetValue(true, 10.0);
+  container.Tick();
+  EXPECT_TRUE(queue.Empty());
+
+  gear->SetValue(true, 1);
+  gear->SetValue(true, 2);
+  speed->SetValue(true, 20.0);
+  container.Tick();
+  ASSERT_EQ(queue.Depth(), 1);
+  ChangeList change_list;
+  ASSERT_TRUE(queue.Pop(change_list));
+  ASSERT_EQ(change_list.size(), 1);
+  EXPECT_EQ(change_list[0], gear);
+
+  // A deleted parameter shall not be dispatched
+  gear->SetValue(true, 3);
+  container.DeleteParameter("Car", "Gear");
+  container.Tick();
+  EXPECT_TRUE(queue.Empty());
+  queue.Exit();
+}
+
+TEST(ChangeNotifier, TestUnsubscribeInCallback) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto& notifier = container.Notifier();
+
+  size_t nof_first = 0;
+  size_t nof_second = 0;
+  size_t second = 0;
+  size_t first = 0;
+  first = notifier.Subscribe([&] (const ChangeList&) {
+    // Shall not deadlock and the second subscriber shall not be called
+    ++nof_first;
+    notifier.Unsubscribe(first);
+    notifier.Unsubscribe(second);
+  });
+  second = notifier.Subscribe([&] (const ChangeList&) {
+    ++nof_second;
+  });
+
+  speed->SetValue(true, 10.0);
+  container.Tick();
+  EXPECT_EQ(nof_first, 1);
+  EXPECT_EQ(nof_second, 0);
+  EXPECT_FALSE(notifier.Active());
+
+  // A callback may also subscribe
+  size_t nof_added = 0;
+  const auto adder = notifier.Subscribe([&] (const ChangeList&) {
+    notifier.Subscribe([&] (const ChangeList&) { ++nof_added; });
+  });
+  speed->SetValue(true, 20.0);
+  container.Tick();
+  EXPECT_EQ(nof_added, 0);
+  notifier.Unsubscribe(adder);
+  speed->SetValue(true, 30.0);
+  container.Tick();
+  EXPECT_EQ(nof_added, 1);
+  EXPECT_EQ(nof_first, 1);
+}
+
+TEST(ChangeNotifier, TestUnsubscribeWaitsForCallback) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto& notifier = container.Notifier();
+
+  std::atomic<bool> running = false;
+  std::atomic<bool> done = false;
+  const auto subscription = notifier.Subscribe([&] (const ChangeList&) {
+    running = true;
+    std::this_thread::sleep_for(100ms);
+    done = true;
+  });
+  speed->SetValue(true, 10.0);
+  std::thread dispatcher([&] { container.Tick(); });
+  while (!running) {
+    std::this_thread::yield();
+  }
+  notifier.Unsubscribe(subscription);
+  EXPECT_TRUE(done);
+  dispatcher.join();
+}
+
+TEST(ChangeNotifier, TestNestedBatch) {
+  ParameterContainer outer_container;
+  auto* speed = outer_container.CreateParameter("Car", "Speed");
+  auto& outer = outer_container.Notifier();
+  ParameterContainer inner_container;
+  auto* gear = inner_container.CreateParameter("Car", "Gear");
+  auto& inner = inner_container.Notifier();
+
+  size_t nof_outer = 0;
+  outer.Subscribe([&] (const ChangeList& list) { nof_outer += list.size(); });
+  size_t nof_inner = 0;
+  inner.Subscribe([&] (const ChangeList& list) { nof_inner += list.size(); });
+
+  // A batch on another notifier doesn't lose the outer batch
+  outer.BeginBatch();
+  speed->SetValue(true, 10.0);
+  inner.BeginBatch();
+  gear->SetValue(true, 1.0);
+  inner.EndBatch();
+  outer_container.Tick();
+  inner_container.Tick();
+  EXPECT_EQ(nof_outer, 0);
+  EXPECT_EQ(nof_inner, 1);
+  outer.EndBatch();
+  outer_container.Tick();
+  EXPECT_EQ(nof_outer, 1);
+
+  // An inner batch on the same notifier joins the outer batch
+  outer.BeginBatch();
+  outer.BeginBatch();
+  speed->SetValue(true, 20.0);
+  outer.EndBatch();
+  outer_container.Tick();
+  EXPECT_EQ(nof_outer, 1);
+  outer.EndBatch();
+  outer_container.Tick();
+  EXPECT_EQ(nof_outer, 2);
+}
+
+}  // namespace workflow::test
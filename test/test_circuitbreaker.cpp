@@ -0,0 +1,153 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include "workflow/circuitbreaker.h"
+#include "workflow/workflow.h"
+#include <util/ixmlfile.h>
+
+using namespace util::xml;
+
+namespace {
+
+constexpr uint64_t kOneSecond = 1'000'000'000;
+
+class MockFailingTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    ++nof_ticks;
+    IsOk(false);
+  }
+  size_t nof_ticks = 0;
+};
+
+}
+
+namespace workflow::test {
+
+TEST(CircuitBreaker, TestProperties) {
+  CircuitBreaker breaker;
+  EXPECT_FALSE(breaker.Enabled());
+  EXPECT_EQ(breaker.State(), CircuitState::Closed);
+
+  breaker.MaxFailures(3);
+  EXPECT_EQ(breaker.MaxFailures(), 3);
+  EXPECT_TRUE(breaker.Enabled());
+
+  breaker.MinBackoff(2.0);
+  EXPECT_DOUBLE_EQ(breaker.MinBackoff(), 2.0);
+
+  breaker.MaxBackoff(60.0);
+  EXPECT_DOUBLE_EQ(breaker.MaxBackoff(), 60.0);
+
+  breaker.Jitter(0.0);
+  EXPECT_DOUBLE_EQ(breaker.Jitter(), 0.0);
+
+  const CircuitBreaker copy(breaker);
+  EXPECT_TRUE(copy == breaker);
+}
+
+TEST(CircuitBreaker, TestBackoff) {
+  CircuitBreaker breaker;
+  breaker.MaxFailures(2);
+  breaker.MinBackoff(1.0);
+  breaker.MaxBackoff(3.0);
+  breaker.Jitter(0.0);
+
+  uint64_t now = 100 * kOneSecond;
+  EXPECT_TRUE(breaker.AllowTick(now));
+  breaker.Failure(now);
+  EXPECT_EQ(breaker.State(), CircuitState::Closed);
+  breaker.Failure(now);
+  EXPECT_EQ(breaker.State(), CircuitState::Open);
+  EXPECT_FALSE(breaker.AllowTick(now));
+  EXPECT_EQ(breaker.NextProbe(), now + kOneSecond);
+
+  // Failed probe doubles the backoff
+  now += kOneSecond;
+  EXPECT_TRUE(breaker.AllowTick(now));
+  EXPECT_EQ(breaker.State(), CircuitState::HalfOpen);
+  breaker.Failure(now);
+  EXPECT_EQ(breaker.State(), CircuitState::Open);
+  EXPECT_EQ(breaker.NextProbe(), now + 2 * kOneSecond);
+
+  // Limited by max backoff
+  now += 2 * kOneSecond;
+  EXPECT_TRUE(breaker.AllowTick(now));
+  breaker.Failure(now);
+  EXPECT_EQ(breaker.NextProbe(), now + 3 * kOneSecond);
+
+  // Successful probe closes the circuit
+  now += 3 * kOneSecond;
+  EXPECT_TRUE(breaker.AllowTick(now));
+  breaker.Success(now);
+  EXPECT_EQ(breaker.State(), CircuitState::Closed);
+  EXPECT_EQ(breaker.Failures(), 0);
+
+  const auto& list = breaker.Transitions();
+  ASSERT_EQ(list.size(), 7);
+  EXPECT_EQ(list.front().from, CircuitState::Closed);
+  EXPECT_EQ(list.front().to, CircuitState::Open);
+  EXPECT_EQ(list.back().from, CircuitState::HalfOpen);
+  EXPECT_EQ(list.back().to, CircuitState::Closed);
+}
+
+TEST(CircuitBreaker, TestJitter) {
+  CircuitBreaker breaker;
+  breaker.MaxFailures(1);
+  breaker.MinBackoff(10.0);
+  breaker.Jitter(0.1);
+
+  constexpr uint64_t now = 100 * kOneSecond;
+  breaker.Failure(now);
+  EXPECT_EQ(breaker.State(), CircuitState::Open);
+  EXPECT_GE(breaker.NextProbe(), now + 9 * kOneSecond);
+  EXPECT_LE(breaker.NextProbe(), now + 11 * kOneSecond);
+}
+
+TEST(CircuitBreaker, TestWorkflow) {
+  Workflow workflow(nullptr);
+  auto temp = std::make_unique<MockFailingTask>();
+  auto* task = temp.get();
+  task->Breaker().MaxFailures(3);
+  task->Breaker().MinBackoff(60.0);
+  workflow.Tasks().emplace_back(std::move(temp));
+
+  for (size_t tick = 0; tick < 10; ++tick) {
+    workflow.Tick();
+  }
+  EXPECT_EQ(task->nof_ticks, 3);
+  EXPECT_EQ(task->Breaker().State(), CircuitState::Open);
+}
+
+TEST(CircuitBreaker, TestXmlStorage) {
+  CircuitBreaker orig;
+  orig.MaxFailures(5);
+  orig.MinBackoff(0.5);
+  orig.MaxBackoff(120.0);
+  orig.Jitter(0.25);
+
+  auto orig_file = CreateXmlFile();
+  ASSERT_TRUE(orig_file);
+  auto& root_node = orig_file->RootName("TaskList");
+  auto& task_node = root_node.AddNode("Task");
+  orig.SaveXml(task_node);
+
+  const std::string xml_string = orig_file->WriteString();
+
+  auto dest_file = CreateXmlFile();
+  dest_file->ParseString(xml_string);
+  EXPECT_STREQ(dest_file->RootName().c_str(), "TaskList");
+
+  const auto* dest_node = dest_file->GetNode("Task");
+  ASSERT_TRUE(dest_node != nullptr);
+
+  CircuitBreaker dest;
+  dest.ReadXml(*dest_node);
+  EXPECT_TRUE(dest == orig);
+}
+
+}  // namespace workflow::test
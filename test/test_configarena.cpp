@@ -0,0 +1,82 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <util/ixmlfile.h>
+#include "workflow/configarena.h"
+#include "workflow/workflowserver.h"
+
+using namespace util::xml;
+
+namespace workflow::test {
+
+TEST(ConfigArena, TestScope) {
+  ConfigArena arena;
+  EXPECT_TRUE(ConfigArena::Current() == nullptr);
+
+  auto heap_task = std::make_unique<ITask>();
+  std::unique_ptr<Workflow> workflow;
+  std::unique_ptr<Parameter> parameter;
+  {
+    ConfigArenaScope scope(&arena);
+    EXPECT_EQ(ConfigArena::Current(), &arena);
+    workflow = std::make_unique<Workflow>(nullptr);
+    workflow->Name("ArenaWorkflow");
+    for (size_t task = 0; task < 10; ++task) {
+      workflow->Tasks().emplace_back(std::make_unique<ITask>());
+    }
+    parameter = std::make_unique<Parameter>();
+    {
+      ConfigArenaScope heap_scope(nullptr);
+      EXPECT_TRUE(ConfigArena::Current() == nullptr);
+    }
+    EXPECT_EQ(ConfigArena::Current(), &arena);
+  }
+  EXPECT_TRUE(ConfigArena::Current() == nullptr);
+  EXPECT_EQ(arena.NofObjects(), 12);
+  EXPECT_GT(arena.NofBytes(), 0);
+  EXPECT_EQ(workflow->Name(), "ArenaWorkflow");
+
+  EXPECT_FALSE(arena.Release()); // Objects still alive
+  workflow.reset();
+  parameter.reset();
+  EXPECT_EQ(arena.NofObjects(), 0);
+  EXPECT_TRUE(arena.Release());
+  EXPECT_EQ(arena.NofBytes(), 0);
+
+  heap_task.reset(); // Heap objects are deleted as normal
+}
+
+TEST(ConfigArena, TestServer) {
+  WorkflowServer orig;
+  orig.Name("ArenaServer");
+  for (size_t index = 0; index < 100; ++index) {
+    Workflow workflow(&orig);
+    workflow.Name("Workflow" + std::to_string(index));
+    workflow.Tasks().emplace_back(std::make_unique<ITask>());
+    orig.AddWorkflow(workflow);
+  }
+  auto orig_file = CreateXmlFile();
+  ASSERT_TRUE(orig_file);
+  auto& root_node = orig_file->RootName("WorkflowServer");
+  orig.SaveXml(root_node);
+
+  WorkflowServer dest;
+  dest.ArenaMode(true);
+  EXPECT_TRUE(dest.ArenaMode());
+  dest.ReadXml(root_node);
+  ASSERT_EQ(dest.Workflows().size(), 100);
+  const auto* arena = dest.GetArena();
+  ASSERT_TRUE(arena != nullptr);
+  EXPECT_GE(arena->NofObjects(), 200);
+
+  dest.Clear();
+  EXPECT_EQ(arena->NofObjects(), 0);
+  EXPECT_EQ(arena->NofBytes(), 0);
+}
+
+}  // namespace workflow::test
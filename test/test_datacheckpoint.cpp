@@ -0,0 +1,162 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <util/syslogmessage.h>
+#include "workflow/datacheckpoint.h"
+#include "workflow/workflow.h"
+#include "sysloginput.h"
+
+using namespace util::syslog;
+using SyslogList = std::vector<SyslogMessage>;
+
+namespace {
+
+struct MockData {
+  std::string name;
+  std::vector<double> value_list;
+};
+
+std::string TestFile(const std::string& name) {
+  auto path = std::filesystem::temp_directory_path() / "test_workflow";
+  std::filesystem::create_directories(path);
+  path.append(name);
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+}
+
+namespace workflow::test {
+
+TEST(DataCheckpoint, TestBasicTypes) {
+  const auto& checkpoint = DataCheckpoint::Instance();
+  const auto filename = TestFile("basic.wfcp");
+  std::string error;
+
+  const std::vector<std::string> orig = {"Line1", "", "Line3"};
+  ASSERT_TRUE(checkpoint.Save(std::make_any<std::vector<std::string>>(orig),
+                              filename, error)) << error;
+  std::any dest;
+  ASSERT_TRUE(checkpoint.Restore(filename, dest, error)) << error;
+  EXPECT_EQ(std::any_cast<std::vector<std::string>>(dest), orig);
+
+  ASSERT_TRUE(checkpoint.Save(std::make_any<double>(1.25), filename, error));
+  ASSERT_TRUE(checkpoint.Restore(filename, dest, error));
+  EXPECT_DOUBLE_EQ(std::any_cast<double>(dest), 1.25);
+
+  EXPECT_FALSE(checkpoint.Save(std::make_any<float>(1.0F), filename, error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(checkpoint.Save(std::any(), filename, error));
+}
+
+TEST(DataCheckpoint, TestCorruptFile) {
+  const auto& checkpoint = DataCheckpoint::Instance();
+  const auto filename = TestFile("corrupt.wfcp");
+  std::string error;
+  ASSERT_TRUE(checkpoint.Save(std::make_any<std::string>("Some text"),
+                              filename, error));
+  // Truncate the payload
+  const auto size = std::filesystem::file_size(filename);
+  std::filesystem::resize_file(filename, size - 2);
+
+  std::any dest = std::make_any<int>(11);
+  EXPECT_FALSE(checkpoint.Restore(filename, dest, error));
+  EXPECT_EQ(std::any_cast<int>(dest), 11); // Unchanged on failure
+
+  {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file << "Not a checkpoint";
+  }
+  EXPECT_FALSE(checkpoint.Restore(filename, dest, error));
+  EXPECT_FALSE(checkpoint.Restore(TestFile("missing.wfcp"), dest, error));
+}
+
+TEST(DataCheckpoint, TestWorkflow) {
+  auto& checkpoint = DataCheckpoint::Instance();
+  checkpoint.RegisterType<MockData>("MockData",
+      [] (const MockData& data, CheckpointWriter& writer) {
+        writer.Write(data.name);
+        writer.Write(static_cast<uint64_t>(data.value_list.size()));
+        for (const double value : data.value_list) {
+          writer.Write(value);
+        }
+      },
+      [] (CheckpointReader& reader, MockData& data) {
+        uint64_t size = 0;
+        if (!reader.Read(data.name) || !reader.Read(size)) {
+          return false;
+        }
+        data.value_list.resize(size);
+        for (auto& value : data.value_list) {
+          if (!reader.Read(value)) {
+            return false;
+          }
+        }
+        return true;
+      });
+
+  const auto filename = TestFile("workflow.wfcp");
+  {
+    Workflow workflow(nullptr);
+    workflow.Checkpoint(filename);
+    workflow.Init();
+    EXPECT_TRUE(workflow.GetData<MockData>() == nullptr);
+    EXPECT_TRUE(workflow.InitData(MockData{"Olle", {1.0, 2.0, 3.0}}));
+    workflow.Exit();
+  }
+  EXPECT_TRUE(std::filesystem::exists(filename));
+
+  Workflow restored(nullptr);
+  restored.Checkpoint(filename);
+  const auto version = restored.DataVersion();
+  restored.Init();
+  const auto* data = restored.GetData<MockData>();
+  ASSERT_TRUE(data != nullptr);
+  EXPECT_EQ(data->name, "Olle");
+  EXPECT_EQ(data->value_list, (std::vector<double>{1.0, 2.0, 3.0}));
+  EXPECT_GT(restored.DataVersion(), version);
+  restored.Exit();
+}
+
+TEST(DataCheckpoint, TestSyslogInput) {
+  const auto filename = TestFile("syslog.wfcp");
+  {
+    Workflow workflow(nullptr);
+    workflow.Checkpoint(filename);
+    workflow.Init();
+    SyslogMessage msg;
+    msg.Hostname("Host1");
+    msg.Message("Saved message");
+    EXPECT_TRUE(workflow.InitData(SyslogList{msg}));
+    workflow.Exit();
+  }
+
+  // The task shall not overwrite the restored messages in its Init()
+  Workflow restored(nullptr);
+  restored.Checkpoint(filename);
+  auto temp = std::make_unique<SyslogInput>();
+  temp->Arguments("--queue=SyslogQueue");
+  auto* task = temp.get();
+  restored.Tasks().emplace_back(std::move(temp));
+  restored.Init();
+  task->Init();
+  EXPECT_TRUE(task->IsOk());
+
+  const auto* syslog_list = restored.GetData<SyslogList>();
+  ASSERT_TRUE(syslog_list != nullptr);
+  ASSERT_EQ(syslog_list->size(), 1);
+  EXPECT_EQ(syslog_list->front().Hostname(), "Host1");
+  EXPECT_EQ(syslog_list->front().Message(), "Saved message");
+  task->Exit();
+  restored.Exit();
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,296 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <util/ixmlfile.h>
+#include "workflow/derivedparameter.h"
+#include "workflow/itask.h"
+#include "workflow/parametercontainer.h"
+#include "workflow/parameterexpression.h"
+
+using namespace util::xml;
+
+namespace workflow::test {
+
+TEST(ParameterExpression, TestCompile) {
+  std::map<std::string, std::unique_ptr<Parameter>> parameter_list;
+  const auto resolver = [&] (const std::string& name) -> Parameter* {
+    auto itr = parameter_list.find(name);
+    return itr != parameter_list.end() ? itr->second.get() : nullptr;
+  };
+  parameter_list.emplace("A", std::make_unique<Parameter>());
+  parameter_list.emplace("Dev.B", std::make_unique<Parameter>());
+  parameter_list.emplace("Oil Temp", std::make_unique<Parameter>());
+  parameter_list["A"]->SetValue(true, 3.0);
+  parameter_list["Dev.B"]->SetValue(true, 4.0);
+  parameter_list["Oil Temp"]->SetValue(true, 80.0);
+
+  const std::map<std::string, double> valid_list = {
+      {"1 + 2 * 3", 7.0},
+      {"(1 + 2) * 3", 9.0},
+      {"-A + 10", 7.0},
+      {"2 ^ 3 ^ 2", 512.0},
+      {"-2 ^ 2", -4.0},
+      {"sqrt(A * A + Dev.B * Dev.B)", 5.0},
+      {"max(A, Dev.B) - min(A, Dev.B)", 1.0},
+      {"abs(A - Dev.B) / 0.5", 2.0},
+      {"{Oil Temp} * 1.8 + 32", 176.0},
+      {"1e3 / A / 2", 1000.0 / 6.0},
+  };
+  for (const auto& [text, expected] : valid_list) {
+    ParameterExpression expression;
+    EXPECT_TRUE(expression.Compile(text, resolver))
+        << text << ": " << expression.LastError();
+    double value = 0.0;
+    EXPECT_TRUE(expression.Evaluate(value)) << text;
+    EXPECT_DOUBLE_EQ(value, expected) << text;
+  }
+
+  ParameterExpression expression;
+  EXPECT_TRUE(expression.Compile("A * A + A", resolver));
+  EXPECT_EQ(expression.Dependencies().size(), 1);
+  EXPECT_EQ(expression.NofInstructions(), 5);
+
+  parameter_list["A"]->Valid(false);
+  double value = 0.0;
+  EXPECT_FALSE(expression.Evaluate(value));
+
+  for (const std::string text : {"", "1 +", "(1 + 2", "foo(1)", "C + 1",
+                                 "1 2", "min(1)", "{A"}) {
+    EXPECT_FALSE(expression.Compile(text, resolver)) << text;
+    EXPECT_FALSE(expression.IsOk());
+    EXPECT_FALSE(expression.LastError().empty()) << text;
+    std::cout << "'" << text << "': " << expression.LastError() << std::endl;
+  }
+}
+
+TEST(DerivedParameter, TestLazyEvaluation) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* offset = container.CreateParameter("Car", "Offset");
+  auto* speed_kmh = container.CreateDerivedParameter("Car", "SpeedKmh",
+                                                     "Speed * 3.6 + Offset");
+  auto* doubled = container.CreateDerivedParameter("Display", "Double",
+                                                   "Car.SpeedKmh * 2");
+  ASSERT_TRUE(speed_kmh != nullptr);
+  ASSERT_TRUE(doubled != nullptr);
+  EXPECT_TRUE(container.CreateDerivedParameter("Car", "Speed", "1") ==
+              nullptr);
+  container.Init();
+  EXPECT_TRUE(speed_kmh->IsOk()) << speed_kmh->LastError();
+  EXPECT_TRUE(doubled->IsOk()) << doubled->LastError();
+
+  double value = 0.0;
+  EXPECT_FALSE(speed_kmh->GetValue(value)); // Inputs are invalid
+
+  speed->SetValue(true, 10.0);
+  offset->SetValue(true, 1.0);
+  EXPECT_TRUE(doubled->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 74.0);
+  EXPECT_TRUE(speed_kmh->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 37.0);
+
+  // No input changed, so nothing is calculated
+  const uint64_t nof_evaluations = speed_kmh->NofEvaluations();
+  for (size_t read = 0; read < 100; ++read) {
+    EXPECT_TRUE(doubled->GetValue(value));
+  }
+  EXPECT_EQ(speed_kmh->NofEvaluations(), nof_evaluations);
+
+  // Many writes but only one calculation on read
+  for (int count = 0; count < 100; ++count) {
+    speed->SetValue(true, static_cast<double>(count));
+  }
+  EXPECT_EQ(speed_kmh->NofEvaluations(), nof_evaluations);
+  EXPECT_TRUE(doubled->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, (99.0 * 3.6 + 1.0) * 2);
+  EXPECT_EQ(speed_kmh->NofEvaluations(), nof_evaluations + 1);
+  EXPECT_EQ(speed_kmh->Expression(), "Speed * 3.6 + Offset");
+}
+
+TEST(DerivedParameter, TestInvalidFormula) {
+  ParameterContainer container;
+  auto* first = container.CreateDerivedParameter("", "First", "Second + 1");
+  auto* second = container.CreateDerivedParameter("", "Second", "First + 1");
+  auto* unknown = container.CreateDerivedParameter("", "Unknown", "Olle");
+  container.Init();
+  EXPECT_FALSE(first->IsOk() && second->IsOk());
+  EXPECT_FALSE(unknown->IsOk());
+  std::cout << "Circular: " << second->LastError() << std::endl;
+  std::cout << "Unknown: " << unknown->LastError() << std::endl;
+
+  double value = 0.0;
+  EXPECT_FALSE(first->GetValue(value));
+  EXPECT_FALSE(unknown->GetValue(value));
+}
+
+TEST(DerivedParameter, TestNoReadEvents) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* speed_kmh = container.CreateDerivedParameter("Car", "SpeedKmh",
+                                                     "Speed * 3.6");
+  speed_kmh->HistorySize(10);
+  container.Init();
+
+  ChangeList change_list;
+  container.Subscribe([&] (const ChangeList& list) {
+    change_list.insert(change_list.end(), list.cbegin(), list.cend());
+  });
+  speed->SetValue(true, 10.0);
+  container.Tick();
+  ASSERT_EQ(change_list.size(), 1);
+  EXPECT_EQ(change_list[0], speed);
+
+  // A calculation on read is not a change
+  change_list.clear();
+  const uint64_t version = speed_kmh->Version();
+  double value = 0.0;
+  EXPECT_TRUE(speed_kmh->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 36.0);
+  EXPECT_TRUE(speed_kmh->GetValue(value));
+  container.Tick();
+  EXPECT_TRUE(change_list.empty());
+  EXPECT_GT(speed_kmh->Version(), version);
+  EXPECT_EQ(speed_kmh->Timestamp(), 0);
+  ASSERT_TRUE(speed_kmh->History() != nullptr);
+  EXPECT_EQ(speed_kmh->History()->Size(), 0);
+}
+
+TEST(DerivedParameter, TestTextValue) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* speed_text = container.CreateDerivedParameter("Car", "SpeedText",
+                                                      "Speed * 2");
+  speed_text->DataType(ParameterDataType::StringType);
+  speed_text->HistorySize(10);
+  container.Init();
+  speed->SetValue(true, 21.0);
+
+  std::string text;
+  EXPECT_TRUE(speed_text->GetValue(text));
+  EXPECT_EQ(text, "42");
+  double value = 0.0;
+  EXPECT_TRUE(speed_text->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 42.0);
+  EXPECT_EQ(speed_text->Timestamp(), 0);
+  EXPECT_EQ(speed_text->History()->Size(), 0);
+}
+
+TEST(DerivedParameter, TestTaskInput) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* speed_kmh = container.CreateDerivedParameter("Car", "SpeedKmh",
+                                                     "Speed * 3.6");
+  container.Init();
+
+  // The task input changes when the formula input changes, without any
+  // read of the derived parameter.
+  ITask task;
+  task.Parameters().push_back(speed_kmh);
+  const uint64_t version = task.InputVersion();
+  speed->SetValue(true, 10.0);
+  EXPECT_NE(task.InputVersion(), version);
+  EXPECT_EQ(speed_kmh->NofEvaluations(), 0);
+}
+
+TEST(DerivedParameter, TestDeleteInput) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* speed_kmh = container.CreateDerivedParameter("Car", "SpeedKmh",
+                                                     "Speed * 3.6");
+  auto* speed_mph = container.CreateDerivedParameter("Car", "SpeedMph",
+                                                     "SpeedKmh / 1.609");
+  container.Init();
+  speed->SetValue(true, 10.0);
+  double value = 0.0;
+  EXPECT_TRUE(speed_mph->GetValue(value));
+
+  container.DeleteParameter("Car", "Speed");
+  EXPECT_FALSE(speed_kmh->IsOk());
+  EXPECT_FALSE(speed_kmh->GetValue(value));
+  EXPECT_TRUE(speed_mph->IsOk());
+  EXPECT_FALSE(speed_mph->GetValue(value));
+
+  container.DeleteParameter("Car", "SpeedKmh");
+  EXPECT_FALSE(speed_mph->IsOk());
+  EXPECT_FALSE(speed_mph->GetValue(value));
+}
+
+TEST(DerivedParameter, TestXmlStorage) {
+  ParameterContainer orig;
+  auto* speed = orig.CreateParameter("Car", "Speed");
+  speed->HistorySize(10);
+  speed->Deadband(0.5);
+  orig.CreateDerivedParameter("Car", "SpeedKmh", "Speed * 3.6");
+
+  auto orig_file = CreateXmlFile();
+  ASSERT_TRUE(orig_file);
+  auto& root_node = orig_file->RootName("WorkflowServer");
+  orig.SaveXml(root_node.AddNode("Engine"));
+  const std::string xml_string = orig_file->WriteString();
+
+  auto dest_file = CreateXmlFile();
+  dest_file->ParseString(xml_string);
+  const auto* engine_node = dest_file->GetNode("Engine");
+  ASSERT_TRUE(engine_node != nullptr);
+  ParameterContainer dest;
+  dest.ReadXml(*engine_node);
+
+  auto* dest_speed = dest.GetParameter("Car", "Speed");
+  ASSERT_TRUE(dest_speed != nullptr);
+  EXPECT_EQ(dest_speed->HistorySize(), 10);
+  ASSERT_TRUE(dest_speed->Deadband() != nullptr);
+  EXPECT_DOUBLE_EQ(dest_speed->Deadband()->absolute, 0.5);
+
+  auto* dest_kmh = dynamic_cast<DerivedParameter*>(
+      dest.GetParameter("Car", "SpeedKmh"));
+  ASSERT_TRUE(dest_kmh != nullptr);
+  EXPECT_EQ(dest_kmh->Expression(), "Speed * 3.6");
+
+  dest.Init();
+  EXPECT_TRUE(dest_kmh->IsOk()) << dest_kmh->LastError();
+  dest_speed->SetValue(true, 10.0);
+  double value = 0.0;
+  EXPECT_TRUE(dest_kmh->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 36.0);
+}
+
+TEST(DerivedParameter, TestSpeed) {
+  constexpr size_t kNofReads = 100'000;
+  ParameterContainer container;
+  auto* input = container.CreateParameter("", "Input");
+  auto* derived = container.CreateDerivedParameter(
+      "", "Derived", "sqrt(abs(Input)) * 2.5 + max(Input, 10) / 3");
+  container.Init();
+  input->SetValue(true, 42.0);
+
+  double value = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t read = 0; read < kNofReads; ++read) {
+    [[maybe_unused]] const bool valid = derived->GetValue(value);
+  }
+  const auto cached = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t read = 0; read < kNofReads; ++read) {
+    input->SetValue(true, static_cast<double>(read));
+    [[maybe_unused]] const bool valid = derived->GetValue(value);
+  }
+  const auto changed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(derived->NofEvaluations(), kNofReads + 1);
+
+  const auto per_read = [&] (auto duration) {
+    return static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration).count()) / kNofReads;
+  };
+  std::cout << "Derived read (ns) Unchanged: " << per_read(cached)
+            << ", Changed: " << per_read(changed) << std::endl;
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,120 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "workflow/enumtable.h"
+#include "workflow/parameter.h"
+
+namespace {
+
+workflow::EnumList MakeStates(size_t nof_states, int64_t step) {
+  workflow::EnumList enum_list;
+  for (size_t state = 0; state < nof_states; ++state) {
+    enum_list.emplace(static_cast<int64_t>(state) * step,
+                      "State" + std::to_string(state));
+  }
+  return enum_list;
+}
+
+}
+
+namespace workflow::test {
+
+TEST(EnumTable, TestLookup) {
+  for (const int64_t step : {1, -3, 1000}) { // Dense and sparse values
+    const auto enum_list = MakeStates(100, step);
+    const EnumTable table(enum_list);
+    EXPECT_EQ(table.Size(), 100);
+    EXPECT_EQ(table.List(), enum_list);
+    for (const auto& [value, name] : enum_list) {
+      const auto* table_name = table.Name(value);
+      ASSERT_TRUE(table_name != nullptr);
+      EXPECT_EQ(*table_name, name);
+      int64_t table_value = 0;
+      EXPECT_TRUE(table.Value(name, table_value));
+      EXPECT_EQ(table_value, value);
+    }
+    int64_t value = 0;
+    EXPECT_FALSE(table.Value("Olle", value));
+    EXPECT_TRUE(table.Name(100 * step) == nullptr);
+    EXPECT_TRUE(table.Name(INT64_MIN) == nullptr);
+  }
+}
+
+TEST(EnumTable, TestIntern) {
+  const size_t nof_interned = EnumTable::NofInterned();
+  EXPECT_TRUE(EnumTable::Intern({}) == nullptr);
+  {
+    Parameter par1;
+    Parameter par2;
+    Parameter par3;
+    par1.Enums(MakeStates(10, 1));
+    par2.Enums(MakeStates(10, 1));
+    par3.Enums(MakeStates(11, 1));
+    EXPECT_EQ(par1.GetEnumTable(), par2.GetEnumTable());
+    EXPECT_NE(par1.GetEnumTable(), par3.GetEnumTable());
+    EXPECT_EQ(EnumTable::NofInterned(), nof_interned + 2);
+
+    Parameter copy(par1);
+    EXPECT_EQ(copy.GetEnumTable(), par1.GetEnumTable());
+    EXPECT_TRUE(copy == par1);
+    EXPECT_FALSE(copy == par3);
+  }
+  EXPECT_EQ(EnumTable::NofInterned(), nof_interned);
+}
+
+TEST(EnumTable, TestSpeed) {
+  constexpr size_t kNofStates = 500;
+  constexpr size_t kNofLookups = 100'000;
+  const auto enum_list = MakeStates(kNofStates, 1);
+  Parameter par;
+  par.DataType(ParameterDataType::EnumType);
+  par.Enums(enum_list);
+
+  std::vector<std::string> input_list;
+  for (size_t index = 0; index < kNofLookups; ++index) {
+    input_list.push_back("State" + std::to_string((index * 7919) %
+                                                  kNofStates));
+  }
+
+  int64_t sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& input : input_list) {
+    const auto itr = std::ranges::find_if(enum_list, [&] (const auto& item) {
+      return item.second == input;
+    });
+    sum += itr->first;
+  }
+  const auto linear = std::chrono::steady_clock::now() - start;
+
+  int64_t table_sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& input : input_list) {
+    par.SetValue(true, input);
+    int64_t value = 0;
+    EXPECT_TRUE(par.GetValue(value));
+    table_sum += value;
+  }
+  const auto table = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(sum, table_sum);
+
+  std::string name;
+  EXPECT_TRUE(par.GetValue(name));
+  EXPECT_EQ(name, input_list.back());
+
+  const auto per_lookup = [&] (auto duration) {
+    return static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration).count()) / kNofLookups;
+  };
+  std::cout << "Name to value (" << kNofStates << " states, ns) Linear: "
+            << per_lookup(linear) << ", Table SetValue+GetValue: "
+            << per_lookup(table) << std::endl;
+}
+
+}  // namespace workflow::test
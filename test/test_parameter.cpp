@@ -4,11 +4,72 @@
  */
 #include <gtest/gtest.h>
 #include "workflow/parameter.h"
+#include "workflow/configarena.h"
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include <util/ixmlfile.h>
 
 using namespace util::xml;
 
+namespace {
+
+/** @brief Reference value with the previous mutex based locking. */
+class MutexValue {
+ public:
+  void SetValue(bool valid, double value) {
+    std::scoped_lock lock(lock_);
+    valid_ = valid;
+    value_ = value;
+  }
+  bool GetValue(double& value) const {
+    std::scoped_lock lock(lock_);
+    value = value_;
+    return valid_;
+  }
+ private:
+  mutable std::mutex lock_;
+  bool valid_ = false;
+  double value_ = 0.0;
+};
+
+template <typename Value>
+double MeasureContention(Value& value, size_t nof_readers) {
+  constexpr size_t kNofReads = 200'000;
+  std::atomic<bool> stop = false;
+  std::thread writer([&] {
+    for (size_t count = 0; !stop; ++count) {
+      value.SetValue(true, static_cast<double>(count));
+    }
+  });
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> reader_list;
+  for (size_t reader = 0; reader < nof_readers; ++reader) {
+    reader_list.emplace_back([&] {
+      double output = 0.0;
+      for (size_t read = 0; read < kNofReads; ++read) {
+        [[maybe_unused]] const bool valid = value.GetValue(output);
+      }
+    });
+  }
+  for (auto& reader : reader_list) {
+    reader.join();
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+  stop = true;
+  writer.join();
+  return static_cast<double>(std::chrono::duration_cast<
+             std::chrono::nanoseconds>(duration).count()) / kNofReads;
+}
+
+}
+
 namespace workflow::test {
 
 TEST(Parameter, TestProperties)
@@ -479,6 +540,182 @@ TEST(Parameter, TestString) {
   }
 }
 
+TEST(Parameter, TestConversion) {
+  Parameter par;
+  par.DataType(ParameterDataType::StringType);
+  {
+    par.SetValue(true, std::string(" +12.5"));
+    double output = 0.0;
+    EXPECT_TRUE(par.GetValue(output));
+    EXPECT_DOUBLE_EQ(output, 12.5);
+    int integer = 0;
+    EXPECT_TRUE(par.GetValue(integer));
+    EXPECT_EQ(integer, 12);
+  }
+  {
+    par.SetValue(true, std::string("Olle"));
+    double output = 1.0;
+    EXPECT_TRUE(par.GetValue(output));
+    EXPECT_DOUBLE_EQ(output, 0.0);
+  }
+  {
+    // Not exact as a double
+    par.SetValue(true, std::string("9007199254740993"));
+    int64_t output = 0;
+    EXPECT_TRUE(par.GetValue(output));
+    EXPECT_EQ(output, 9'007'199'254'740'993);
+  }
+  {
+    par.SetValue(true, 0.1);
+    std::string output;
+    EXPECT_TRUE(par.GetValue(output));
+    EXPECT_EQ(output, "0.1");
+    par.SetValue(true, -42);
+    EXPECT_TRUE(par.GetValue(output));
+    EXPECT_EQ(output, "-42");
+  }
+
+  Parameter number;
+  number.DataType(ParameterDataType::FloatType);
+  {
+    number.SetValue(true, 1.0 / 3.0);
+    std::string output;
+    EXPECT_TRUE(number.GetValue(output));
+    number.SetValue(false, 0.0);
+    number.SetValue(true, output);
+    double value = 0.0;
+    EXPECT_TRUE(number.GetValue(value));
+    EXPECT_EQ(value, 1.0 / 3.0); // Round trip
+    number.SetValue(false, std::string("Pelle"));
+    EXPECT_FALSE(number.GetValue(value));
+    EXPECT_EQ(value, 1.0 / 3.0);
+  }
+}
+
+TEST(Parameter, TestConversionSpeed) {
+  constexpr size_t kNofConversions = 100'000;
+  Parameter par;
+  par.DataType(ParameterDataType::StringType);
+  par.SetValue(true, std::string("1234.5678"));
+  const std::string text = "1234.5678";
+
+  double sum = 0.0;
+  double shadow_sum = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofConversions; ++count) {
+    std::istringstream input(text);
+    double value = 0.0;
+    input >> value;
+    sum += value;
+  }
+  const auto stream_read = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofConversions; ++count) {
+    double value = 0.0;
+    [[maybe_unused]] const bool valid = par.GetValue(value);
+    shadow_sum += value;
+  }
+  const auto shadow_read = std::chrono::steady_clock::now() - start;
+  EXPECT_DOUBLE_EQ(sum, shadow_sum);
+
+  size_t length = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofConversions; ++count) {
+    length += std::to_string(static_cast<double>(count) / 7.0).size();
+  }
+  const auto string_write = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofConversions; ++count) {
+    Parameter::NumberBuffer buffer;
+    length += Parameter::FormatNumber(static_cast<double>(count) / 7.0,
+                                      buffer).size();
+  }
+  const auto chars_write = std::chrono::steady_clock::now() - start;
+  EXPECT_GT(length, 0);
+
+  const auto per_call = [&] (auto duration) {
+    return static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration).count()) / kNofConversions;
+  };
+  std::cout << "Text to double (ns) Stream: " << per_call(stream_read)
+            << ", Shadow: " << per_call(shadow_read) << std::endl;
+  std::cout << "Double to text (ns) to_string: " << per_call(string_write)
+            << ", to_chars: " << per_call(chars_write) << std::endl;
+}
+
+TEST(Parameter, TestDeadband) {
+  Parameter par;
+  EXPECT_TRUE(par.Deadband() == nullptr);
+  par.Deadband(0.5);
+  ASSERT_TRUE(par.Deadband() != nullptr);
+
+  par.SetValue(true, 10.0);
+  const uint64_t version = par.Version();
+  const uint64_t timestamp = par.Timestamp();
+  par.SetValue(true, 10.3);
+  EXPECT_EQ(par.Version(), version); // Not reported
+  EXPECT_EQ(par.Timestamp(), timestamp);
+  double value = 0.0;
+  EXPECT_TRUE(par.GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 10.3); // Raw value is updated
+
+  par.SetValue(false, 10.3);
+  EXPECT_GT(par.Version(), version); // Valid flag changed
+  par.SetValue(true, 10.6);
+  const uint64_t valid_version = par.Version();
+  par.SetValue(true, 11.2);
+  EXPECT_GT(par.Version(), valid_version);
+  EXPECT_EQ(par.Deadband()->nof_suppressed, 1);
+
+  // 10% relative band
+  par.Deadband(0.0, 0.1);
+  par.SetValue(true, 100.0);
+  const uint64_t relative_version = par.Version();
+  par.SetValue(true, 109.0);
+  EXPECT_EQ(par.Version(), relative_version);
+  par.SetValue(true, 111.0);
+  EXPECT_GT(par.Version(), relative_version);
+
+  // Hysteresis on a direction change
+  Parameter level;
+  level.Deadband(0.1, 0.0, 1.0);
+  level.SetValue(true, 0.0);
+  level.SetValue(true, 1.0); // Up
+  const uint64_t up_version = level.Version();
+  level.SetValue(true, 0.5); // Down within 0.1 + 1.0
+  EXPECT_EQ(level.Version(), up_version);
+  level.SetValue(true, -0.5);
+  EXPECT_GT(level.Version(), up_version);
+
+  Parameter copy(level);
+  EXPECT_TRUE(copy == level);
+  copy.Deadband(0.0);
+  EXPECT_TRUE(copy.Deadband() == nullptr);
+  EXPECT_FALSE(copy == level);
+}
+
+TEST(Parameter, TestDeadbandTraffic) {
+  constexpr size_t kNofSamples = 100'000;
+  Parameter raw;
+  Parameter filtered;
+  filtered.Deadband(0.05, 0.0, 0.01);
+  uint64_t noise = 1;
+  for (size_t sample = 0; sample < kNofSamples; ++sample) {
+    // Slow ramp with +-0.01 noise
+    noise = noise * 6364136223846793005ULL + 1442695040888963407ULL;
+    const double value = static_cast<double>(sample) * 1e-5 +
+        (static_cast<double>(noise >> 11) / 9007199254740992.0 - 0.5) * 0.02;
+    raw.SetValue(true, value);
+    filtered.SetValue(true, value);
+  }
+  EXPECT_LT(filtered.Version() * 100, raw.Version());
+  std::cout << "Reported changes (" << kNofSamples << " samples) Raw: "
+            << raw.Version() << ", Deadband: " << filtered.Version()
+            << std::endl;
+}
+
 TEST(Parameter, TestByteArray) {
   Parameter par;
   par.DataType(ParameterDataType::ByteArrayType);
@@ -501,4 +738,96 @@ TEST(Parameter, TestByteArray) {
     std::cout << "Byte Array: " << output << std::endl;
   }
 }
+
+TEST(Parameter, TestConcurrent) {
+  Parameter number;
+  number.DataType(ParameterDataType::UnsignedType);
+  Parameter text;
+  text.DataType(ParameterDataType::StringType);
+
+  // The valid flag shall always match the value it was set together with.
+  constexpr uint64_t kNofWrites = 100'000;
+  std::atomic<bool> stop = false;
+  std::atomic<size_t> nof_errors = 0;
+  std::vector<std::thread> reader_list;
+  for (size_t reader = 0; reader < 3; ++reader) {
+    reader_list.emplace_back([&] {
+      while (!stop) {
+        uint64_t value = 0;
+        const bool valid = number.GetValue(value);
+        if (value > 0 && valid != (value % 2 == 0)) {
+          ++nof_errors;
+        }
+        std::string output;
+        const bool text_valid = text.GetValue(output);
+        if (!output.empty() && text_valid != (output.size() % 2 == 1)) {
+          ++nof_errors;
+        }
+      }
+    });
+  }
+  for (uint64_t value = 1; value <= kNofWrites; ++value) {
+    number.SetValue(value % 2 == 0, value);
+    text.SetValue(value % 2 == 0, std::string(value % 16 + 1, 'A'));
+  }
+  stop = true;
+  for (auto& reader : reader_list) {
+    reader.join();
+  }
+  EXPECT_EQ(nof_errors, 0);
+  EXPECT_EQ(number.Version(), kNofWrites);
+
+  uint64_t value = 0;
+  EXPECT_TRUE(number.GetValue(value));
+  EXPECT_EQ(value, kNofWrites);
+  number.Valid(false);
+  EXPECT_FALSE(number.Valid());
+  EXPECT_EQ(number.Version(), kNofWrites + 1);
+}
+
+TEST(Parameter, TestContention) {
+  const size_t nof_readers =
+      std::max(std::thread::hardware_concurrency(), 2U) - 1;
+  MutexValue mutex_value;
+  Parameter parameter;
+  parameter.DataType(ParameterDataType::FloatType);
+
+  const double mutex_ns = MeasureContention(mutex_value, nof_readers);
+  const double lock_free_ns = MeasureContention(parameter, nof_readers);
+  std::cout << "GetValue (" << nof_readers << " readers, 1 writer) Mutex: "
+            << mutex_ns << " ns, Lock-free: " << lock_free_ns << " ns"
+            << std::endl;
+}
+
+TEST(Parameter, TestMemoryUsage) {
+  constexpr size_t kNofParameters = 1'000'000;
+  ConfigArena arena;
+  std::vector<std::unique_ptr<Parameter>> parameter_list;
+  parameter_list.reserve(kNofParameters);
+  {
+    ConfigArenaScope scope(&arena);
+    for (size_t index = 0; index < kNofParameters; ++index) {
+      auto parameter = std::make_unique<Parameter>();
+      parameter->Name("P" + std::to_string(index));
+      parameter->Device("Device");
+      parameter->SetValue(true, static_cast<double>(index));
+      parameter_list.push_back(std::move(parameter));
+    }
+  }
+  EXPECT_EQ(arena.NofObjects(), kNofParameters);
+  EXPECT_LE(sizeof(Parameter), 152);
+
+  double value = 0;
+  EXPECT_TRUE(parameter_list.back()->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, kNofParameters - 1);
+  EXPECT_TRUE(parameter_list.back()->Unit().empty());
+
+  std::cout << "Parameter size: " << sizeof(Parameter) << " bytes, "
+            << kNofParameters << " parameters: "
+            << arena.NofBytes() / kNofParameters << " bytes per parameter"
+            << std::endl;
+  parameter_list.clear();
+  EXPECT_TRUE(arena.Release());
+}
+
 }  // namespace mdf::test
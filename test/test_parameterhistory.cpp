@@ -0,0 +1,113 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "workflow/parameter.h"
+#include "workflow/parameterhistory.h"
+
+namespace workflow::test {
+
+TEST(ParameterHistory, TestRing) {
+  ParameterHistory history(4);
+  EXPECT_EQ(history.Capacity(), 4);
+  EXPECT_EQ(history.Size(), 0);
+  for (uint64_t time = 1; time <= 6; ++time) {
+    history.Add(time * 1'000'000'000, time != 3, static_cast<double>(time));
+  }
+  EXPECT_EQ(history.Size(), 4);
+  EXPECT_EQ(history.NofSamples(), 6);
+
+  HistoryList sample_list;
+  history.Range(0, UINT64_MAX, sample_list);
+  ASSERT_EQ(sample_list.size(), 4);
+  EXPECT_EQ(sample_list.front().value, 3.0);
+  EXPECT_FALSE(sample_list.front().valid);
+  EXPECT_EQ(sample_list.back().value, 6.0);
+
+  history.Range(4'000'000'000, 5'000'000'000, sample_list);
+  ASSERT_EQ(sample_list.size(), 2);
+  EXPECT_EQ(sample_list[0].value, 4.0);
+  EXPECT_EQ(sample_list[1].value, 5.0);
+
+  HistoryStatistics statistics;
+  EXPECT_TRUE(history.Statistics(0, UINT64_MAX, statistics));
+  EXPECT_EQ(statistics.count, 3); // Sample 3 is invalid
+  EXPECT_DOUBLE_EQ(statistics.min, 4.0);
+  EXPECT_DOUBLE_EQ(statistics.max, 6.0);
+  EXPECT_DOUBLE_EQ(statistics.average, 5.0);
+  EXPECT_DOUBLE_EQ(statistics.rate, 1.0);
+
+  EXPECT_FALSE(history.Statistics(0, 1, statistics));
+}
+
+TEST(ParameterHistory, TestParameter) {
+  Parameter par;
+  EXPECT_EQ(par.HistorySize(), 0);
+  EXPECT_TRUE(par.History() == nullptr);
+  EXPECT_EQ(par.Timestamp(), 0);
+
+  par.HistorySize(10);
+  par.DataType(ParameterDataType::SignedType);
+  for (int value = 1; value <= 20; ++value) {
+    const uint64_t last_time = par.Timestamp();
+    par.SetValue(true, value);
+    EXPECT_GE(par.Timestamp(), last_time);
+  }
+  const auto* history = par.History();
+  ASSERT_TRUE(history != nullptr);
+  EXPECT_EQ(history->Size(), 10);
+
+  HistoryList sample_list;
+  history->Range(0, par.Timestamp(), sample_list);
+  ASSERT_EQ(sample_list.size(), 10);
+  EXPECT_EQ(sample_list.back().value, 20.0);
+  EXPECT_EQ(sample_list.back().timestamp, par.Timestamp());
+  for (size_t index = 1; index < sample_list.size(); ++index) {
+    EXPECT_GE(sample_list[index].timestamp, sample_list[index - 1].timestamp);
+  }
+
+  // Text values use their numeric value
+  Parameter text;
+  text.DataType(ParameterDataType::StringType);
+  text.HistorySize(2);
+  text.SetValue(true, std::string("12.5"));
+  text.History()->Range(0, UINT64_MAX, sample_list);
+  ASSERT_EQ(sample_list.size(), 1);
+  EXPECT_EQ(sample_list[0].value, 12.5);
+
+  Parameter copy(par);
+  EXPECT_EQ(copy.HistorySize(), 10);
+  EXPECT_TRUE(copy == par);
+  copy.HistorySize(0);
+  EXPECT_FALSE(copy == par);
+}
+
+TEST(ParameterHistory, TestConcurrent) {
+  Parameter par;
+  par.HistorySize(64);
+  std::atomic<bool> stop = false;
+  std::thread writer([&] {
+    for (size_t count = 1; !stop; ++count) {
+      par.SetValue(true, static_cast<double>(count));
+    }
+  });
+  HistoryList sample_list;
+  for (size_t read = 0; read < 10'000; ++read) {
+    par.History()->Range(0, UINT64_MAX, sample_list);
+    for (size_t index = 1; index < sample_list.size(); ++index) {
+      // Each sample was written after the previous one
+      EXPECT_GT(sample_list[index].value, sample_list[index - 1].value);
+      EXPECT_GE(sample_list[index].timestamp,
+                sample_list[index - 1].timestamp);
+    }
+  }
+  stop = true;
+  writer.join();
+}
+
+}  // namespace workflow::test
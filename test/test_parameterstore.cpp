@@ -0,0 +1,173 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "workflow/parametercontainer.h"
+#include "workflow/parameterstore.h"
+
+namespace workflow::test {
+
+TEST(ParameterStore, TestBind) {
+  ParameterContainer container;
+  container.ColumnStore(true);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* gear = container.CreateParameter("Car", "Gear");
+  gear->DataType(ParameterDataType::SignedType);
+  auto* name = container.CreateParameter("Car", "Name");
+  name->DataType(ParameterDataType::StringType);
+
+  speed->SetValue(true, 12.5);
+  EXPECT_TRUE(container.GetStore() == nullptr);
+  container.Init();
+  const auto* store = container.GetStore();
+  ASSERT_TRUE(store != nullptr);
+  ASSERT_EQ(store->Size(), 3);
+  EXPECT_EQ(speed->Store(), store);
+  EXPECT_EQ(gear->StoreIndex(), 1);
+
+  // Init() invalidates all parameters
+  double value = 0.0;
+  EXPECT_FALSE(speed->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 12.5);
+
+  const uint64_t start = store->LastSequence();
+  speed->SetValue(true, 88.0);
+  gear->SetValue(true, 3);
+  name->SetValue(true, std::string("Delorean"));
+  EXPECT_EQ(store->LastSequence(), start + 3);
+
+  std::vector<size_t> changed_list;
+  store->ChangedSince(start + 1, changed_list);
+  EXPECT_EQ(changed_list, std::vector<size_t>({1, 2}));
+
+  StoreSnapshot snapshot;
+  store->Snapshot(snapshot);
+  EXPECT_EQ(snapshot.sequence, start + 3);
+  EXPECT_EQ(snapshot.value_list[1], 3);
+  EXPECT_EQ(snapshot.state_list[0] & ValueSlot::kValidBit,
+            ValueSlot::kValidBit);
+  EXPECT_GT(snapshot.timestamp_list[2], snapshot.timestamp_list[0]);
+
+  std::string text;
+  EXPECT_TRUE(name->GetValue(text));
+  EXPECT_EQ(text, "Delorean");
+
+  // Unbind moves the value back into the parameter
+  speed->Bind(nullptr, 0);
+  EXPECT_TRUE(speed->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 88.0);
+  container.Clear();
+  EXPECT_TRUE(container.GetStore() == nullptr);
+}
+
+TEST(ParameterStore, TestScan) {
+  constexpr size_t kNofParameters = 10'000;
+  ParameterContainer container;
+  container.ColumnStore(true);
+  std::vector<Parameter*> parameter_list;
+  for (size_t index = 0; index < kNofParameters; ++index) {
+    parameter_list.push_back(container.CreateParameter(
+        "Device", "Parameter" + std::to_string(index)));
+  }
+  container.Init();
+  const auto* store = container.GetStore();
+  ASSERT_TRUE(store != nullptr);
+
+  std::vector<uint64_t> version_list(kNofParameters, 0);
+  for (size_t index = 0; index < kNofParameters; ++index) {
+    version_list[index] = parameter_list[index]->Version();
+  }
+  const uint64_t sequence = store->LastSequence();
+  for (size_t index = 0; index < kNofParameters; index += 10) {
+    parameter_list[index]->SetValue(true, static_cast<double>(index));
+  }
+
+  // Find the changed parameters by visiting each parameter object
+  const auto object_start = std::chrono::steady_clock::now();
+  std::vector<size_t> object_list;
+  for (size_t index = 0; index < kNofParameters; ++index) {
+    if (parameter_list[index]->Version() != version_list[index]) {
+      object_list.push_back(index);
+    }
+  }
+  const auto object = std::chrono::steady_clock::now() - object_start;
+
+  const auto column_start = std::chrono::steady_clock::now();
+  std::vector<size_t> column_list;
+  store->ChangedSince(sequence, column_list);
+  const auto column = std::chrono::steady_clock::now() - column_start;
+
+  EXPECT_EQ(column_list.size(), kNofParameters / 10);
+  EXPECT_EQ(column_list, object_list);
+
+  using std::chrono::nanoseconds;
+  std::cout << "Changed scan (" << kNofParameters << " parameters) Objects: "
+            << std::chrono::duration_cast<nanoseconds>(object).count()
+            << " ns, Column store: "
+            << std::chrono::duration_cast<nanoseconds>(column).count()
+            << " ns" << std::endl;
+}
+
+TEST(ParameterStore, TestSnapshot) {
+  ParameterContainer container;
+  container.ColumnStore(true);
+  auto* left = container.CreateParameter("Balance", "Left");
+  auto* right = container.CreateParameter("Balance", "Right");
+  auto* other = container.CreateParameter("Other", "Counter");
+  other->DataType(ParameterDataType::UnsignedType);
+  container.Init();
+  auto* store = container.GetStore();
+  ASSERT_TRUE(store != nullptr);
+
+  // The writer updates two related values as a group. The sum shall
+  // always be zero in a snapshot.
+  std::atomic<bool> stop = false;
+  std::thread writer([&] {
+    for (uint64_t count = 1; !stop; ++count) {
+      store->BeginGroup();
+      left->SetValue(true, static_cast<double>(count));
+      right->SetValue(true, -static_cast<double>(count));
+      store->EndGroup();
+      other->SetValue(true, count);
+    }
+  });
+
+  size_t nof_errors = 0;
+  for (size_t count = 0; count < 1'000; ++count) {
+    StoreSnapshot snapshot;
+    EXPECT_TRUE(container.Snapshot(snapshot, "Balance"));
+    if (snapshot.value_list.size() != 2) {
+      ++nof_errors;
+      continue;
+    }
+    const double sum = std::bit_cast<double>(snapshot.value_list[0]) +
+                       std::bit_cast<double>(snapshot.value_list[1]);
+    if (sum != 0.0) {
+      ++nof_errors;
+    }
+  }
+  stop = true;
+  writer.join();
+  EXPECT_EQ(nof_errors, 0);
+
+  other->SetValue(true, 42);
+  StoreSnapshot snapshot;
+  ASSERT_TRUE(container.Snapshot(snapshot));
+  EXPECT_EQ(snapshot.value_list.size(), 3);
+  EXPECT_TRUE(snapshot.index_list.empty());
+  EXPECT_EQ(snapshot.sequence, store->LastSequence());
+  EXPECT_EQ(snapshot.value_list[2], 42);
+  EXPECT_EQ(snapshot.state_list[2] & ValueSlot::kValidBit,
+            ValueSlot::kValidBit);
+}
+
+}  // namespace workflow::test
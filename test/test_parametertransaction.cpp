@@ -0,0 +1,100 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "workflow/parametercontainer.h"
+#include "workflow/parametertransaction.h"
+
+namespace workflow::test {
+
+TEST(ParameterTransaction, TestCommit) {
+  ParameterContainer container;
+  container.ColumnStore(true);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* gear = container.CreateParameter("Car", "Gear");
+  gear->DataType(ParameterDataType::SignedType);
+  auto* name = container.CreateParameter("Car", "Name");
+  name->DataType(ParameterDataType::StringType);
+  auto* lights = container.CreateParameter("Car", "Lights");
+  lights->DataType(ParameterDataType::BooleanType);
+  container.Init();
+
+  size_t nof_calls = 0;
+  size_t nof_changed = 0;
+  container.Subscribe([&] (const ChangeList& change_list) {
+    ++nof_calls;
+    nof_changed += change_list.size();
+  });
+
+  ParameterTransaction transaction(container);
+  transaction.SetValue(*speed, true, 88.0);
+  transaction.SetValue(*gear, true, -1);
+  transaction.SetValue(*name, true, "Delorean");
+  transaction.SetValue(*lights, true, true);
+  EXPECT_EQ(transaction.Size(), 4);
+
+  // Nothing is written before the commit
+  double speed_value = 0.0;
+  EXPECT_FALSE(speed->GetValue(speed_value));
+
+  const auto* store = container.GetStore();
+  const uint64_t sequence = store->LastSequence();
+  transaction.Commit();
+  EXPECT_TRUE(transaction.Empty());
+  EXPECT_EQ(transaction.NofCommits(), 1);
+  EXPECT_GT(transaction.LastLatency(), 0);
+  EXPECT_EQ(store->LastSequence(), sequence + 4);
+
+  EXPECT_TRUE(speed->GetValue(speed_value));
+  EXPECT_DOUBLE_EQ(speed_value, 88.0);
+  int gear_value = 0;
+  EXPECT_TRUE(gear->GetValue(gear_value));
+  EXPECT_EQ(gear_value, -1);
+  std::string name_value;
+  EXPECT_TRUE(name->GetValue(name_value));
+  EXPECT_EQ(name_value, "Delorean");
+  bool lights_value = false;
+  EXPECT_TRUE(lights->GetValue(lights_value));
+  EXPECT_TRUE(lights_value);
+
+  container.Tick();
+  EXPECT_EQ(nof_calls, 1);
+  EXPECT_EQ(nof_changed, 4);
+}
+
+TEST(ParameterTransaction, TestLatency) {
+  constexpr size_t kNofParameters = 1'000;
+  ParameterContainer container;
+  container.ColumnStore(true);
+  std::vector<Parameter*> parameter_list;
+  for (size_t index = 0; index < kNofParameters; ++index) {
+    parameter_list.push_back(container.CreateParameter(
+        "Frame", "Channel" + std::to_string(index)));
+  }
+  container.Init();
+  size_t nof_calls = 0;
+  container.Subscribe([&] (const ChangeList&) { ++nof_calls; });
+
+  ParameterTransaction transaction(container);
+  for (size_t frame = 0; frame < 10; ++frame) {
+    for (size_t index = 0; index < kNofParameters; ++index) {
+      transaction.SetValue(*parameter_list[index], true,
+                           static_cast<double>(frame * index));
+    }
+    transaction.Commit();
+    container.Tick();
+  }
+  EXPECT_EQ(nof_calls, 10);
+  EXPECT_EQ(transaction.NofCommits(), 10);
+  EXPECT_GE(transaction.MaxLatency(), transaction.LastLatency());
+  std::cout << "Commit (" << kNofParameters << " values) Last: "
+            << transaction.LastLatency() << " ns, Max: "
+            << transaction.MaxLatency() << " ns" << std::endl;
+}
+
+}  // namespace workflow::test
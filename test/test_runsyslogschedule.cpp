@@ -0,0 +1,322 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <util/syslogmessage.h>
+#include "workflow/workflowserver.h"
+#include "workflow/workflowpool.h"
+#include "runsyslogschedule.h"
+
+using namespace util::syslog;
+
+namespace {
+
+class MockReceiverTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    auto* workflow = GetWorkflow();
+    ASSERT_TRUE(workflow != nullptr);
+    ++nof_ticks;
+    if (const auto* msg_list = workflow->GetData<workflow::SyslogList>();
+        msg_list != nullptr) {
+      nof_messages += msg_list->size();
+    } else if (workflow->GetData<SyslogMessage>() != nullptr) {
+      ++nof_messages;
+    }
+    IsOk(true);
+  }
+  size_t nof_ticks = 0;
+  size_t nof_messages = 0;
+};
+
+class MockPoolReceiverTask : public workflow::ITask {
+ public:
+  explicit MockPoolReceiverTask(std::atomic<size_t>* nof_messages)
+  : nof_messages_(nof_messages) {
+  }
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override {
+    return std::make_unique<MockPoolReceiverTask>(*this);
+  }
+  void Init() override {
+    ITask::Init();
+    auto* workflow = GetWorkflow();
+    ASSERT_TRUE(workflow != nullptr);
+    workflow->InitData(workflow::SyslogList());
+  }
+  void Tick() override {
+    const auto* msg_list = GetWorkflow()->GetData<workflow::SyslogList>();
+    ASSERT_TRUE(msg_list != nullptr);
+    *nof_messages_ += msg_list->size();
+    IsOk(true);
+  }
+  void Exit() override {
+    GetWorkflow()->ClearData();
+    ITask::Exit();
+  }
+ private:
+  std::atomic<size_t>* nof_messages_;
+};
+
+class MockStrandReceiverTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    // Not locked. Relies on the strand.
+    const auto* msg = GetWorkflow()->GetData<SyslogMessage>();
+    ASSERT_TRUE(msg != nullptr);
+    message_list.insert(msg->Message());
+    ++nof_messages;
+    IsOk(true);
+  }
+  std::set<std::string> message_list;
+  size_t nof_messages = 0;
+};
+
+workflow::SyslogList CreateMessageList(size_t nof_messages) {
+  workflow::SyslogList msg_list(nof_messages);
+  for (auto& msg : msg_list) {
+    msg.Message("Syslog message text");
+  }
+  return msg_list;
+}
+
+}
+
+namespace workflow::test {
+
+TEST(RunSyslogSchedule, TestPerMessage) {
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  auto temp_receiver = std::make_unique<MockReceiverTask>();
+  auto* receiver = temp_receiver.get();
+  remote->Tasks().emplace_back(std::move(temp_receiver));
+  remote->Init();
+  EXPECT_TRUE(remote->InitData(SyslogMessage()));
+
+  Workflow producer(&server);
+  auto temp_task = std::make_unique<RunSyslogSchedule>();
+  auto* task = temp_task.get();
+  task->Arguments("--name=Remote");
+  producer.Tasks().emplace_back(std::move(temp_task));
+  producer.Init();
+  task->Init();
+  EXPECT_TRUE(producer.InitData(CreateMessageList(10)));
+
+  producer.Tick();
+  EXPECT_TRUE(task->IsOk());
+  EXPECT_EQ(receiver->nof_ticks, 10);
+  EXPECT_EQ(receiver->nof_messages, 10);
+  EXPECT_EQ(producer.GetData<SyslogList>()->size(), 10);
+}
+
+TEST(RunSyslogSchedule, TestReplacedRemote) {
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  remote->Init();
+  EXPECT_TRUE(remote->InitData(SyslogMessage()));
+
+  Workflow producer(&server);
+  auto temp_task = std::make_unique<RunSyslogSchedule>();
+  auto* task = temp_task.get();
+  task->Arguments("--name=Remote");
+  producer.Tasks().emplace_back(std::move(temp_task));
+  producer.Init();
+  task->Init();
+  EXPECT_TRUE(producer.InitData(CreateMessageList(10)));
+  producer.Tick();
+  EXPECT_TRUE(task->IsOk());
+
+  // The remote workflow is replaced after the first tick
+  server.AddWorkflow(remote_def);
+  auto* replaced = server.GetWorkflow("Remote");
+  ASSERT_TRUE(replaced != nullptr);
+  auto temp_receiver = std::make_unique<MockReceiverTask>();
+  auto* receiver = temp_receiver.get();
+  replaced->Tasks().emplace_back(std::move(temp_receiver));
+  replaced->Init();
+  EXPECT_TRUE(replaced->InitData(SyslogMessage()));
+  producer.Tick();
+  EXPECT_TRUE(task->IsOk());
+  EXPECT_EQ(receiver->nof_messages, 10);
+
+  server.DeleteWorkflow(replaced);
+  producer.Tick();
+  EXPECT_FALSE(task->IsOk());
+}
+
+TEST(RunSyslogSchedule, TestBatch) {
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  auto temp_receiver = std::make_unique<MockReceiverTask>();
+  auto* receiver = temp_receiver.get();
+  remote->Tasks().emplace_back(std::move(temp_receiver));
+  remote->Init();
+  EXPECT_TRUE(remote->InitData(SyslogList()));
+
+  Workflow producer(&server);
+  auto temp_task = std::make_unique<RunSyslogSchedule>();
+  auto* task = temp_task.get();
+  task->Arguments("--name=Remote --batch --batch-size=4");
+  producer.Tasks().emplace_back(std::move(temp_task));
+  producer.Init();
+  task->Init();
+  EXPECT_TRUE(producer.InitData(CreateMessageList(10)));
+
+  producer.Tick();
+  EXPECT_TRUE(task->IsOk());
+  EXPECT_EQ(receiver->nof_ticks, 3);
+  EXPECT_EQ(receiver->nof_messages, 10);
+  EXPECT_TRUE(producer.GetData<SyslogList>()->empty());
+
+  // Batch without size limit
+  task->Arguments("--name=Remote --batch");
+  task->Init();
+  EXPECT_TRUE(producer.InitData(CreateMessageList(10)));
+  producer.Tick();
+  EXPECT_EQ(receiver->nof_ticks, 4);
+  EXPECT_EQ(receiver->nof_messages, 20);
+}
+
+TEST(RunSyslogSchedule, TestPool) {
+  std::atomic<size_t> nof_messages = 0;
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  remote_def.Instances(4);
+  remote_def.Tasks().emplace_back(
+      std::make_unique<MockPoolReceiverTask>(&nof_messages));
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  remote->Init();
+  auto* pool = remote->Pool();
+  ASSERT_TRUE(pool != nullptr);
+  for (size_t index = 0; index < pool->Size(); ++index) {
+    // The pool shall initialize the instance tasks
+    auto* instance = pool->Instance(index);
+    ASSERT_TRUE(instance != nullptr);
+    EXPECT_TRUE(instance->GetData<SyslogList>() != nullptr);
+  }
+
+  Workflow producer(&server);
+  auto temp_task = std::make_unique<RunSyslogSchedule>();
+  auto* task = temp_task.get();
+  task->Arguments("--name=Remote --batch");
+  producer.Tasks().emplace_back(std::move(temp_task));
+  producer.Init();
+  task->Init();
+
+  auto msg_list = CreateMessageList(20);
+  for (size_t index = 0; index < msg_list.size(); ++index) {
+    msg_list[index].Hostname("Host" + std::to_string(index));
+  }
+  EXPECT_TRUE(producer.InitData(msg_list));
+  producer.Tick();
+  EXPECT_TRUE(task->IsOk());
+  EXPECT_EQ(nof_messages, 20);
+  EXPECT_TRUE(producer.GetData<SyslogList>()->empty());
+
+  remote->Exit();
+  EXPECT_TRUE(remote->Pool() == nullptr);
+}
+
+TEST(RunSyslogSchedule, TestPoolFailure) {
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  remote_def.Instances(2);
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  remote->Init(); // No task creates the instance data
+
+  Workflow producer(&server);
+  auto temp_task = std::make_unique<RunSyslogSchedule>();
+  auto* task = temp_task.get();
+  task->Arguments("--name=Remote --batch");
+  producer.Tasks().emplace_back(std::move(temp_task));
+  producer.Init();
+  task->Init();
+  EXPECT_TRUE(producer.InitData(CreateMessageList(10)));
+
+  // The undelivered messages are dropped and reported
+  producer.Tick();
+  EXPECT_FALSE(task->IsOk());
+  EXPECT_FALSE(task->LastError().empty());
+  EXPECT_TRUE(producer.GetData<SyslogList>()->empty());
+  remote->Exit();
+}
+
+TEST(RunSyslogSchedule, TestStrandProducers) {
+  constexpr size_t kNofProducers = 4;
+  constexpr size_t kNofMessages = 100;
+
+  WorkflowServer server;
+  Workflow remote_def(&server);
+  remote_def.Name("Remote");
+  remote_def.Strand(StrandPolicy::Serial);
+  server.AddWorkflow(remote_def);
+  auto* remote = server.GetWorkflow("Remote");
+  ASSERT_TRUE(remote != nullptr);
+  auto temp_receiver = std::make_unique<MockStrandReceiverTask>();
+  auto* receiver = temp_receiver.get();
+  remote->Tasks().emplace_back(std::move(temp_receiver));
+  remote->Init();
+  EXPECT_TRUE(remote->InitData(SyslogMessage()));
+
+  std::vector<std::unique_ptr<Workflow>> producer_list;
+  for (size_t producer = 0; producer < kNofProducers; ++producer) {
+    auto workflow = std::make_unique<Workflow>(&server);
+    auto task = std::make_unique<RunSyslogSchedule>();
+    task->Arguments("--name=Remote");
+    workflow->Tasks().emplace_back(std::move(task));
+    workflow->Init();
+    workflow->Tasks()[0]->Init();
+
+    auto msg_list = CreateMessageList(kNofMessages);
+    for (size_t index = 0; index < msg_list.size(); ++index) {
+      msg_list[index].Message(std::to_string(producer) + ":"
+                              + std::to_string(index));
+    }
+    EXPECT_TRUE(workflow->InitData(msg_list));
+    producer_list.emplace_back(std::move(workflow));
+  }
+
+  std::vector<std::thread> thread_list;
+  for (auto& producer : producer_list) {
+    thread_list.emplace_back([&producer] { producer->Tick(); });
+  }
+  for (auto& thread : thread_list) {
+    thread.join();
+  }
+
+  // All messages shall be delivered once
+  EXPECT_EQ(receiver->nof_messages, kNofProducers * kNofMessages);
+  EXPECT_EQ(receiver->message_list.size(), kNofProducers * kNofMessages);
+  for (const auto& producer : producer_list) {
+    EXPECT_TRUE(producer->Tasks()[0]->IsOk());
+    producer->Exit();
+  }
+  remote->Exit();
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,242 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "workflow/parametercontainer.h"
+#include "workflow/sharedparameterstore.h"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string SegmentName() {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return "workflow_test_" + std::to_string(now.count());
+}
+
+}  // namespace
+
+namespace workflow::test {
+
+TEST(SharedParameterStore, TestSchema) {
+  const auto segment = SegmentName();
+  ParameterContainer container;
+  container.SharedMemory(segment);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  speed->Unit("km/h");
+  auto* gear = container.CreateParameter("Car", "Gear");
+  gear->DataType(ParameterDataType::SignedType);
+  auto* name = container.CreateParameter("Driver", "Name");
+  name->DataType(ParameterDataType::StringType);
+  container.Init();
+
+  const auto* owner = container.GetSharedStore();
+  ASSERT_TRUE(owner != nullptr);
+  EXPECT_TRUE(owner->IsOwner());
+  EXPECT_TRUE(owner->Online());
+  EXPECT_EQ(speed->Store(), container.GetStore());
+
+  SharedParameterStore reader;
+  ASSERT_TRUE(reader.Open(segment)) << reader.LastError();
+  EXPECT_FALSE(reader.IsOwner());
+  ASSERT_EQ(reader.Schema().size(), 3);
+  ASSERT_TRUE(reader.GetStore() != nullptr);
+  EXPECT_EQ(reader.GetStore()->Size(), 3);
+
+  const auto* speed_entry = reader.Find("Car", "Speed");
+  ASSERT_TRUE(speed_entry != nullptr);
+  EXPECT_EQ(speed_entry->index, speed->StoreIndex());
+  EXPECT_EQ(speed_entry->unit, "km/h");
+  EXPECT_EQ(speed_entry->data_type, ParameterDataType::FloatType);
+
+  const auto* gear_entry = reader.Find("Car", "Gear");
+  ASSERT_TRUE(gear_entry != nullptr);
+  EXPECT_EQ(gear_entry->data_type, ParameterDataType::SignedType);
+  const auto* name_entry = reader.Find("Driver", "Name");
+  ASSERT_TRUE(name_entry != nullptr);
+  EXPECT_EQ(name_entry->data_type, ParameterDataType::StringType);
+  EXPECT_TRUE(reader.Find("Car", "Olle") == nullptr);
+
+  SharedParameterStore missing;
+  EXPECT_FALSE(missing.Open(segment + "_missing"));
+  EXPECT_FALSE(missing.IsOk());
+  EXPECT_FALSE(missing.LastError().empty());
+}
+
+TEST(SharedParameterStore, TestValues) {
+  const auto segment = SegmentName();
+  ParameterContainer container;
+  container.SharedMemory(segment);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* gear = container.CreateParameter("Car", "Gear");
+  gear->DataType(ParameterDataType::SignedType);
+  auto* lights = container.CreateParameter("Car", "Lights");
+  lights->DataType(ParameterDataType::BooleanType);
+  auto* name = container.CreateParameter("Driver", "Name");
+  name->DataType(ParameterDataType::StringType);
+  container.Init();
+
+  SharedParameterStore reader;
+  ASSERT_TRUE(reader.Open(segment)) << reader.LastError();
+  const auto* speed_entry = reader.Find("Car", "Speed");
+  const auto* gear_entry = reader.Find("Car", "Gear");
+  const auto* lights_entry = reader.Find("Car", "Lights");
+  const auto* name_entry = reader.Find("Driver", "Name");
+  ASSERT_TRUE(speed_entry != nullptr && gear_entry != nullptr &&
+              lights_entry != nullptr && name_entry != nullptr);
+
+  double value = 1.0;
+  EXPECT_FALSE(reader.GetValue(*speed_entry, value));
+
+  const uint64_t sequence = reader.GetStore()->LastSequence();
+  speed->SetValue(true, 88.5);
+  gear->SetValue(true, -1);
+  lights->SetValue(true, true);
+  name->SetValue(true, std::string("42.5"));
+
+  EXPECT_TRUE(reader.GetValue(*speed_entry, value));
+  EXPECT_DOUBLE_EQ(value, 88.5);
+  EXPECT_TRUE(reader.GetValue(*gear_entry, value));
+  EXPECT_DOUBLE_EQ(value, -1.0);
+  EXPECT_TRUE(reader.GetValue(*lights_entry, value));
+  EXPECT_DOUBLE_EQ(value, 1.0);
+  EXPECT_TRUE(reader.GetValue(*name_entry, value));
+  EXPECT_DOUBLE_EQ(value, 42.5);
+
+  std::vector<size_t> index_list;
+  reader.GetStore()->ChangedSince(sequence, index_list);
+  EXPECT_EQ(index_list.size(), 4);
+
+  StoreSnapshot snapshot;
+  reader.GetStore()->Snapshot(snapshot);
+  ASSERT_EQ(snapshot.value_list.size(), 4);
+  EXPECT_EQ(snapshot.sequence, container.GetStore()->LastSequence());
+  EXPECT_GT(snapshot.timestamp_list[speed_entry->index], 0);
+
+  speed->Valid(false);
+  EXPECT_FALSE(reader.GetValue(*speed_entry, value));
+
+  // The reader keeps its mapping but sees that the owner has left.
+  container.Clear();
+  EXPECT_FALSE(reader.Online());
+  SharedParameterStore late_reader;
+  EXPECT_FALSE(late_reader.Open(segment));
+}
+
+TEST(SharedParameterStore, TestDeadOwner) {
+  const auto segment = SegmentName();
+  ParameterContainer container;
+  container.SharedMemory(segment);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  container.Init();
+  speed->SetValue(true, 88.5);
+  auto* store = container.GetStore();
+  ASSERT_TRUE(store != nullptr);
+
+  SharedParameterStore reader;
+  ASSERT_TRUE(reader.Open(segment)) << reader.LastError();
+  const auto* entry = reader.Find("Car", "Speed");
+  ASSERT_TRUE(entry != nullptr);
+
+  // A second owner may not replace the live segment.
+  auto parameter = std::make_unique<Parameter>();
+  parameter->Device("Car");
+  parameter->Name("Gear");
+  std::vector<std::unique_ptr<Parameter>> parameter_list;
+  parameter_list.push_back(std::move(parameter));
+  SharedParameterStore other_owner;
+  EXPECT_FALSE(other_owner.Create(segment, parameter_list));
+  EXPECT_FALSE(other_owner.LastError().empty());
+  other_owner.Close();
+  EXPECT_TRUE(reader.Online());
+
+  // The owner died in the middle of a write and a group.
+  double value = 0.0;
+  store->State(entry->index).fetch_or(ValueSlot::kWriteBit);
+  EXPECT_FALSE(reader.GetValue(*entry, value));
+  store->State(entry->index).fetch_and(~ValueSlot::kWriteBit);
+  EXPECT_TRUE(reader.GetValue(*entry, value));
+  EXPECT_DOUBLE_EQ(value, 88.5);
+
+  store->BeginGroup();
+  StoreSnapshot snapshot;
+  EXPECT_FALSE(reader.GetStore()->Snapshot(snapshot));
+  EXPECT_GT(snapshot.nof_retries, 0);
+  store->EndGroup();
+  EXPECT_TRUE(reader.GetStore()->Snapshot(snapshot));
+}
+
+TEST(SharedParameterStore, TestCrashedOwner) {
+#ifdef _WIN32
+  GTEST_SKIP() << "The test uses fork().";
+#else
+  const auto segment = SegmentName();
+  std::vector<std::unique_ptr<Parameter>> parameter_list;
+  parameter_list.push_back(std::make_unique<Parameter>());
+  parameter_list[0]->Device("Car");
+  parameter_list[0]->Name("Speed");
+
+  // The child creates the segment and dies without closing it
+  const pid_t child = fork();
+  if (child == 0) {
+    SharedParameterStore owner;
+    auto store = owner.Create(segment, parameter_list);
+    _exit(store ? 0 : 1);
+  }
+  ASSERT_GT(child, 0);
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  SharedParameterStore reader;
+  EXPECT_FALSE(reader.Open(segment));
+
+  SharedParameterStore owner;
+  auto store = owner.Create(segment, parameter_list);
+  ASSERT_TRUE(store) << owner.LastError();
+  EXPECT_TRUE(reader.Open(segment)) << reader.LastError();
+  reader.Close();
+  store.reset();
+  owner.Close();
+#endif
+}
+
+TEST(SharedParameterStore, TestReadLatency) {
+  constexpr size_t kNofReads = 1'000'000;
+  const auto segment = SegmentName();
+  ParameterContainer container;
+  container.SharedMemory(segment);
+  auto* speed = container.CreateParameter("Car", "Speed");
+  container.Init();
+  speed->SetValue(true, 88.5);
+
+  SharedParameterStore reader;
+  ASSERT_TRUE(reader.Open(segment)) << reader.LastError();
+  const auto* entry = reader.Find("Car", "Speed");
+  ASSERT_TRUE(entry != nullptr);
+
+  double sum = 0.0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t read = 0; read < kNofReads; ++read) {
+    double value = 0.0;
+    reader.GetValue(*entry, value);
+    sum += value;
+  }
+  const auto stop = std::chrono::steady_clock::now();
+  const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      stop - start).count();
+  std::cout << "Shared read: " << time / kNofReads << " ns" << std::endl;
+  EXPECT_DOUBLE_EQ(sum, 88.5 * kNofReads);
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,134 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include "workflow/parametercontainer.h"
+#include "workflow/typedparameter.h"
+
+namespace workflow::test {
+
+TEST(TypedParameter, TestBind) {
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  auto* gear = container.CreateParameter("Car", "Gear");
+  gear->DataType(ParameterDataType::SignedType);
+  auto* count = container.CreateParameter("Car", "Count");
+  count->DataType(ParameterDataType::UnsignedType);
+  auto* lights = container.CreateParameter("Car", "Lights");
+  lights->DataType(ParameterDataType::BooleanType);
+  auto* name = container.CreateParameter("Car", "Name");
+  name->DataType(ParameterDataType::StringType);
+  container.Init();
+
+  EXPECT_TRUE(container.GetTypedParameter<double>("Car", "Speed").IsOk());
+  EXPECT_TRUE(container.GetTypedParameter<float>("Car", "Speed").IsOk());
+  EXPECT_FALSE(container.GetTypedParameter<int>("Car", "Speed").IsOk());
+  EXPECT_TRUE(container.GetTypedParameter<int>("Car", "Gear").IsOk());
+  EXPECT_FALSE(container.GetTypedParameter<uint32_t>("Car", "Gear").IsOk());
+  EXPECT_TRUE(container.GetTypedParameter<uint64_t>("Car", "Count").IsOk());
+  EXPECT_TRUE(container.GetTypedParameter<bool>("Car", "Lights").IsOk());
+  EXPECT_FALSE(container.GetTypedParameter<bool>("Car", "Name").IsOk());
+  EXPECT_FALSE(container.GetTypedParameter<double>("Car", "Olle").IsOk());
+
+  auto speed_handle = container.GetTypedParameter<double>("Car", "Speed");
+  EXPECT_EQ(speed_handle.GetParameter(), speed);
+  double value = 1.0;
+  EXPECT_FALSE(speed_handle.Get(value));
+  speed_handle.Set(true, 88.5);
+  EXPECT_TRUE(speed_handle.Get(value));
+  EXPECT_DOUBLE_EQ(value, 88.5);
+  EXPECT_TRUE(speed->GetValue(value));
+  EXPECT_DOUBLE_EQ(value, 88.5);
+
+  auto gear_handle = container.GetTypedParameter<int>("Car", "Gear");
+  gear->SetValue(true, -1);
+  EXPECT_EQ(gear_handle.Value(), -1);
+  gear_handle.Set(true, 3);
+  int64_t gear_value = 0;
+  EXPECT_TRUE(gear->GetValue(gear_value));
+  EXPECT_EQ(gear_value, 3);
+
+  auto lights_handle = container.GetTypedParameter<bool>("Car", "Lights");
+  lights_handle.Set(true, true);
+  EXPECT_TRUE(lights_handle.Value());
+
+  TypedParameter<double> unbound;
+  EXPECT_FALSE(unbound.IsOk());
+  EXPECT_FALSE(unbound.Get(value));
+  unbound.Set(true, 1.0);
+}
+
+TEST(TypedParameter, TestHooks) {
+  ParameterContainer container;
+  auto* input = container.CreateParameter("", "Input");
+  container.CreateDerivedParameter("", "Output", "Input * 2");
+  size_t nof_calls = 0;
+  container.Subscribe([&] (const ChangeList&) { ++nof_calls; });
+  container.Init();
+
+  // A derived parameter is calculated in its get hook
+  auto input_handle = container.GetTypedParameter<double>("", "Input");
+  auto output_handle = container.GetTypedParameter<double>("", "Output");
+  ASSERT_TRUE(output_handle.IsOk());
+  input_handle.Set(true, 21.0);
+  EXPECT_DOUBLE_EQ(output_handle.Value(), 42.0);
+
+  // Subscribers are notified
+  container.Tick();
+  EXPECT_GE(nof_calls, 1);
+  EXPECT_GT(input->Version(), 0);
+}
+
+TEST(TypedParameter, TestSpeed) {
+  constexpr size_t kNofCalls = 1'000'000;
+  ParameterContainer container;
+  auto* speed = container.CreateParameter("Car", "Speed");
+  container.Init();
+  auto handle = container.GetTypedParameter<double>("Car", "Speed");
+  speed->SetValue(true, 1.5);
+
+  double sum = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofCalls; ++count) {
+    double value = 0.0;
+    [[maybe_unused]] const bool valid = speed->GetValue(value);
+    sum += value;
+  }
+  const auto generic_get = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofCalls; ++count) {
+    double value = 0.0;
+    [[maybe_unused]] const bool valid = handle.Get(value);
+    sum -= value;
+  }
+  const auto typed_get = std::chrono::steady_clock::now() - start;
+  EXPECT_DOUBLE_EQ(sum, 0.0);
+
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofCalls; ++count) {
+    speed->SetValue(true, static_cast<double>(count));
+  }
+  const auto generic_set = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t count = 0; count < kNofCalls; ++count) {
+    handle.Set(true, static_cast<double>(count));
+  }
+  const auto typed_set = std::chrono::steady_clock::now() - start;
+
+  const auto per_call = [&] (auto duration) {
+    return static_cast<double>(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(duration).count()) / kNofCalls;
+  };
+  std::cout << "Get (ns) GetValue: " << per_call(generic_get)
+            << ", Typed: " << per_call(typed_get) << std::endl;
+  std::cout << "Set (ns) SetValue: " << per_call(generic_set)
+            << ", Typed: " << per_call(typed_set) << std::endl;
+}
+
+}  // namespace workflow::test
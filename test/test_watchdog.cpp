@@ -0,0 +1,117 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "workflow/watchdog.h"
+#include "workflow/workflow.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+class MockSlowTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    std::this_thread::sleep_for(sleep_time);
+    IsOk(true);
+  }
+  std::chrono::milliseconds sleep_time = 0ms;
+};
+
+}
+
+namespace workflow::test {
+
+TEST(Watchdog, TestTimeout) {
+  ITask task;
+  EXPECT_DOUBLE_EQ(task.Timeout(), 0.0);
+  task.Timeout(1.0);
+  EXPECT_DOUBLE_EQ(task.Timeout(), 1.0);
+
+  constexpr uint64_t start = 1'000'000'000;
+  EXPECT_FALSE(task.CheckTimeout(start)); // Not in tick
+  task.TickStarted(start);
+  EXPECT_FALSE(task.CheckTimeout(start + 500'000'000));
+  EXPECT_FALSE(task.Stalled());
+  EXPECT_TRUE(task.CheckTimeout(start + 1'500'000'000));
+  EXPECT_TRUE(task.Stalled());
+  EXPECT_FALSE(task.CheckTimeout(start + 1'600'000'000)); // Already reported
+  task.TickStopped(start + 2'000'000'000);
+  EXPECT_FALSE(task.Stalled());
+  EXPECT_EQ(task.StallDuration(), 2'000'000'000);
+}
+
+TEST(Watchdog, TestStalledTask) {
+  Workflow workflow(nullptr);
+  workflow.Name("SlowWorkflow");
+  auto temp = std::make_unique<MockSlowTask>();
+  temp->Name("SlowTask");
+  temp->Timeout(0.05);
+  temp->sleep_time = 500ms;
+  auto* task = temp.get();
+  workflow.Tasks().emplace_back(std::move(temp));
+  workflow.Init();
+
+  Watchdog watchdog;
+  watchdog.Period(10);
+  watchdog.AttachWorkflow(&workflow);
+  watchdog.Start();
+  EXPECT_TRUE(watchdog.IsRunning());
+
+  std::thread tick_thread([&] { workflow.Tick(); });
+  std::this_thread::sleep_for(200ms);
+  EXPECT_TRUE(task->Stalled());
+  EXPECT_TRUE(workflow.Stalled());
+  tick_thread.join();
+  EXPECT_FALSE(workflow.Stalled());
+
+  watchdog.Stop();
+  EXPECT_FALSE(watchdog.IsRunning());
+
+  const auto report_list = watchdog.Reports();
+  ASSERT_EQ(report_list.size(), 1);
+  const auto& report = report_list[0];
+  EXPECT_EQ(report.workflow, "SlowWorkflow");
+  EXPECT_EQ(report.task, "SlowTask");
+  EXPECT_GE(report.duration, 50'000'000);
+  EXPECT_NE(report.thread, 0);
+  EXPECT_GE(task->StallDuration(), 500'000'000);
+
+  watchdog.ClearReports();
+  EXPECT_TRUE(watchdog.Reports().empty());
+  watchdog.DetachWorkflows();
+  workflow.Exit();
+}
+
+TEST(Watchdog, TestPoolExit) {
+  Workflow workflow(nullptr);
+  workflow.Name("PoolWorkflow");
+  workflow.Instances(4);
+  auto temp = std::make_unique<MockSlowTask>();
+  temp->Timeout(10.0);
+  workflow.Tasks().emplace_back(std::move(temp));
+
+  Watchdog watchdog;
+  watchdog.Period(1);
+  watchdog.AttachWorkflow(&workflow);
+  watchdog.Start();
+
+  // The pool is created and deleted while the watchdog checks it
+  const uint64_t start = ITask::SteadyTime();
+  for (size_t cycle = 0; cycle < 50; ++cycle) {
+    workflow.Init();
+    workflow.Tick();
+    workflow.Exit();
+  }
+  EXPECT_GE(ITask::SteadyTime(), start);
+  watchdog.DetachWorkflow(&workflow);
+  watchdog.Stop();
+  EXPECT_TRUE(watchdog.Reports().empty());
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,242 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <thread>
+#include "workflow/workflow.h"
+#include "workflow/workflowpool.h"
+#include "workflow/parameter.h"
+
+namespace {
+
+class MockCountTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    ++nof_ticks;
+    IsOk(true);
+  }
+  size_t nof_ticks = 0;
+};
+
+class MockTemplateTask : public workflow::ITask {
+ public:
+  explicit MockTemplateTask(const std::string& name) {
+    Name(name);
+    Template("Template" + name);
+  }
+};
+
+class MockSerialTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    if (++nof_running > 1) {
+      overlap = true;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    ++nof_ticks;
+    --nof_running;
+    IsOk(true);
+  }
+  std::atomic<int> nof_running = 0;
+  std::atomic<bool> overlap = false;
+  size_t nof_ticks = 0; ///< Not atomic. Relies on the strand.
+};
+
+}
+
+namespace workflow::test {
+
+TEST(Workflow, TestIncremental) {
+  Parameter parameter;
+  parameter.DataType(ParameterDataType::FloatType);
+
+  Workflow workflow(nullptr);
+  EXPECT_FALSE(workflow.Incremental());
+  workflow.Incremental(true);
+  EXPECT_TRUE(workflow.Incremental());
+
+  auto temp1 = std::make_unique<MockCountTask>();
+  auto* parameter_task = temp1.get();
+  parameter_task->Parameters().push_back(&parameter);
+  workflow.Tasks().emplace_back(std::move(temp1));
+
+  auto temp2 = std::make_unique<MockCountTask>();
+  auto* data_task = temp2.get();
+  data_task->ReadsData(true);
+  workflow.Tasks().emplace_back(std::move(temp2));
+
+  auto temp3 = std::make_unique<MockCountTask>();
+  auto* free_task = temp3.get();
+  workflow.Tasks().emplace_back(std::move(temp3));
+
+  workflow.Init();
+  EXPECT_TRUE(workflow.InitData<int>(0));
+
+  for (size_t tick = 0; tick < 5; ++tick) {
+    workflow.Tick();
+  }
+  EXPECT_EQ(parameter_task->nof_ticks, 1);
+  EXPECT_EQ(data_task->nof_ticks, 1);
+  EXPECT_EQ(free_task->nof_ticks, 5);
+
+  parameter.SetValue(true, 1.23);
+  workflow.Tick();
+  EXPECT_EQ(parameter_task->nof_ticks, 2);
+  EXPECT_EQ(data_task->nof_ticks, 1);
+
+  auto* data = workflow.GetData<int>();
+  ASSERT_TRUE(data != nullptr);
+  *data = 11;
+  workflow.DataChanged();
+  workflow.Tick();
+  EXPECT_EQ(parameter_task->nof_ticks, 2);
+  EXPECT_EQ(data_task->nof_ticks, 2);
+
+  EXPECT_EQ(workflow.NofTaskRuns(), 11);
+  EXPECT_EQ(workflow.NofTaskSkips(), 10);
+  workflow.ResetStatistics();
+  EXPECT_EQ(workflow.NofTaskRuns(), 0);
+  EXPECT_EQ(workflow.NofTaskSkips(), 0);
+
+  workflow.Incremental(false);
+  workflow.Tick();
+  EXPECT_EQ(parameter_task->nof_ticks, 3);
+  EXPECT_EQ(data_task->nof_ticks, 3);
+  workflow.Exit();
+}
+
+TEST(Workflow, TestInstancePool) {
+  Workflow workflow(nullptr);
+  workflow.Name("PoolWorkflow");
+  workflow.Instances(4);
+  EXPECT_EQ(workflow.Instances(), 4);
+  workflow.AddTask(ITask());
+  EXPECT_TRUE(workflow.Pool() == nullptr);
+  EXPECT_EQ(workflow.SelectInstance("Host1"), &workflow);
+
+  workflow.Init();
+  auto* pool = workflow.Pool();
+  ASSERT_TRUE(pool != nullptr);
+  ASSERT_EQ(pool->Size(), 4);
+  for (size_t index = 0; index < pool->Size(); ++index) {
+    auto* instance = pool->Instance(index);
+    ASSERT_TRUE(instance != nullptr);
+    EXPECT_EQ(instance->InstanceIndex(), index);
+    EXPECT_EQ(instance->Name(), workflow.Name());
+    EXPECT_TRUE(instance->Pool() == nullptr);
+  }
+
+  // Same key shall always give the same instance
+  const auto* host1 = workflow.SelectInstance("Host1");
+  EXPECT_EQ(workflow.SelectInstance("Host1"), host1);
+  EXPECT_NE(host1, &workflow);
+
+  pool->SetPartitionFunction([] (const std::string& key, size_t) {
+    return key.size();
+  });
+  EXPECT_EQ(pool->Partition("Host1"), 1);
+  EXPECT_EQ(pool->Partition("Host"), 0);
+
+  std::array<std::atomic<size_t>, 4> count_list = {};
+  std::mutex thread_lock;
+  std::set<std::thread::id> thread_list;
+  for (size_t run = 0; run < 10; ++run) {
+    pool->Run([&] (Workflow& instance, size_t index) {
+      EXPECT_EQ(instance.InstanceIndex(), index);
+      ++count_list[index];
+      std::scoped_lock lock(thread_lock);
+      thread_list.insert(std::this_thread::get_id());
+    });
+  }
+  for (const auto& count : count_list) {
+    EXPECT_EQ(count, 10);
+  }
+  EXPECT_EQ(thread_list.size(), 4);
+  EXPECT_EQ(thread_list.count(std::this_thread::get_id()), 0);
+
+  workflow.Tick();
+  workflow.Exit();
+  EXPECT_TRUE(workflow.Pool() == nullptr);
+}
+
+TEST(Workflow, TestTaskLookup) {
+  Workflow workflow(nullptr);
+  for (const auto* name : {"Task1", "Task2", "Task3"}) {
+    workflow.Tasks().emplace_back(std::make_unique<MockTemplateTask>(name));
+  }
+  workflow.Init();
+  auto* task2 = workflow.GetTask("TASK2");
+  ASSERT_TRUE(task2 != nullptr);
+  EXPECT_EQ(task2->Name(), "Task2");
+  EXPECT_EQ(workflow.GetTaskByTemplateName("templatetask2"), task2);
+  EXPECT_TRUE(workflow.GetTask("Task4") == nullptr);
+
+  workflow.MoveUp(task2);
+  EXPECT_EQ(workflow.GetTask("task2"), task2);
+  EXPECT_EQ(workflow.Tasks()[0].get(), task2);
+
+  // Changes made directly on the task list are still found
+  workflow.Tasks()[1]->Name("Renamed");
+  EXPECT_EQ(workflow.GetTask("renamed"), workflow.Tasks()[1].get());
+  auto* task4 = workflow.Tasks().emplace_back(
+      std::make_unique<MockTemplateTask>("Task4")).get();
+  EXPECT_EQ(workflow.GetTask("Task4"), task4);
+  EXPECT_EQ(workflow.GetTaskByTemplateName("TemplateTask4"), task4);
+  workflow.DeleteTask(task4);
+  workflow.DeleteTask(task2);
+  EXPECT_TRUE(workflow.GetTask("Task2") == nullptr);
+  EXPECT_EQ(workflow.GetTask("Renamed"), workflow.Tasks()[0].get());
+  EXPECT_EQ(workflow.GetTaskByTemplateName("TemplateTask3"),
+            workflow.Tasks()[1].get());
+  workflow.Exit();
+}
+
+TEST(Workflow, TestStrand) {
+  constexpr size_t kNofThreads = 4;
+  constexpr size_t kNofTriggers = 100;
+
+  for (const auto policy : {StrandPolicy::Serial, StrandPolicy::Coalesce}) {
+    Workflow workflow(nullptr);
+    workflow.Strand(policy);
+    EXPECT_EQ(workflow.Strand(), policy);
+    auto temp = std::make_unique<MockSerialTask>();
+    auto* task = temp.get();
+    workflow.Tasks().emplace_back(std::move(temp));
+    workflow.Init();
+
+    std::vector<std::thread> thread_list;
+    for (size_t thread = 0; thread < kNofThreads; ++thread) {
+      thread_list.emplace_back([&] {
+        for (size_t trigger = 0; trigger < kNofTriggers; ++trigger) {
+          workflow.Tick();
+        }
+      });
+    }
+    for (auto& thread : thread_list) {
+      thread.join();
+    }
+    workflow.Exit();
+
+    EXPECT_FALSE(task->overlap);
+    EXPECT_EQ(workflow.NofTriggers(), kNofThreads * kNofTriggers);
+    EXPECT_EQ(task->nof_ticks + workflow.NofCoalesced(),
+              kNofThreads * kNofTriggers);
+    if (policy == StrandPolicy::Serial) {
+      EXPECT_EQ(workflow.NofCoalesced(), 0);
+    }
+  }
+
+  Workflow workflow(nullptr);
+  workflow.StrandAsString("coalesce");
+  EXPECT_EQ(workflow.Strand(), StrandPolicy::Coalesce);
+  EXPECT_EQ(workflow.StrandAsString(), "Coalesce");
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,116 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include "workflow/workflowprototype.h"
+#include "workflow/workflowserver.h"
+#include "runsyslogschedule.h"
+#include "syslogpublisher.h"
+
+namespace {
+
+class MockCloneTask : public workflow::ITask {
+ public:
+  [[nodiscard]] std::unique_ptr<ITask> Clone() const override {
+    return std::make_unique<MockCloneTask>(*this);
+  }
+  size_t value = 0;
+};
+
+}
+
+namespace workflow::test {
+
+TEST(WorkflowPrototype, TestClone) {
+  Workflow workflow(nullptr);
+  auto temp = std::make_unique<MockCloneTask>();
+  temp->value = 42;
+  workflow.Tasks().emplace_back(std::move(temp));
+  workflow.Tasks().emplace_back(std::make_unique<SyslogPublisher>());
+
+  const Workflow copy(workflow);
+  ASSERT_EQ(copy.Tasks().size(), 2);
+  const auto* mock = dynamic_cast<const MockCloneTask*>(copy.Tasks()[0].get());
+  ASSERT_TRUE(mock != nullptr);
+  EXPECT_EQ(mock->value, 42);
+  EXPECT_NE(copy.Tasks()[0].get(), workflow.Tasks()[0].get());
+  EXPECT_TRUE(dynamic_cast<const SyslogPublisher*>(copy.Tasks()[1].get())
+              != nullptr);
+  EXPECT_TRUE(copy == workflow);
+}
+
+TEST(WorkflowPrototype, TestInstantiate) {
+  WorkflowServer server;
+  Workflow definition(&server);
+  definition.Name("Definition");
+
+  // Plain task templates as read from a configuration file
+  const RunSyslogSchedule schedule;
+  definition.Tasks().emplace_back(std::make_unique<ITask>(schedule));
+  definition.Tasks().emplace_back(std::make_unique<ITask>());
+
+  const WorkflowPrototype prototype(definition);
+  const auto& compiled = prototype.Definition().Tasks();
+  ASSERT_EQ(compiled.size(), 2);
+  EXPECT_TRUE(dynamic_cast<const RunSyslogSchedule*>(compiled[0].get())
+              != nullptr);
+  EXPECT_TRUE(compiled[1]); // No factory for the template
+
+  for (size_t index = 0; index < 3; ++index) {
+    const auto instance = prototype.Instantiate(index);
+    ASSERT_TRUE(instance);
+    EXPECT_EQ(instance->Name(), "Definition");
+    EXPECT_EQ(instance->InstanceIndex(), index);
+    ASSERT_EQ(instance->Tasks().size(), 2);
+    const auto* task = instance->Tasks()[0].get();
+    EXPECT_TRUE(dynamic_cast<const RunSyslogSchedule*>(task) != nullptr);
+    EXPECT_NE(task, compiled[0].get());
+    EXPECT_EQ(task->Template(), schedule.Template());
+    EXPECT_EQ(task->Arguments(), schedule.Arguments());
+  }
+}
+
+TEST(WorkflowPrototype, TestSpeed) {
+  constexpr size_t kNofTasks = 20;
+  constexpr size_t kNofInstances = 1'000;
+
+  WorkflowServer server;
+  Workflow definition(&server);
+  const RunSyslogSchedule schedule;
+  for (size_t task = 0; task < kNofTasks; ++task) {
+    definition.Tasks().emplace_back(std::make_unique<ITask>(schedule));
+  }
+
+  // Reference: create each instance through the task factories
+  const auto factory_start = std::chrono::steady_clock::now();
+  for (size_t index = 0; index < kNofInstances; ++index) {
+    Workflow instance(&server);
+    for (const auto& task : definition.Tasks()) {
+      instance.AddTask(*task);
+    }
+    EXPECT_EQ(instance.Tasks().size(), kNofTasks);
+  }
+  const auto factory = std::chrono::steady_clock::now() - factory_start;
+
+  const auto prototype_start = std::chrono::steady_clock::now();
+  const WorkflowPrototype prototype(definition);
+  for (size_t index = 0; index < kNofInstances; ++index) {
+    const auto instance = prototype.Instantiate(index);
+    EXPECT_EQ(instance->Tasks().size(), kNofTasks);
+  }
+  const auto cloned = std::chrono::steady_clock::now() - prototype_start;
+
+  using std::chrono::nanoseconds;
+  std::cout << "Instantiate (" << kNofTasks << " tasks) Factory: "
+            << std::chrono::duration_cast<nanoseconds>(factory).count() /
+               kNofInstances << " ns, Prototype: "
+            << std::chrono::duration_cast<nanoseconds>(cloned).count() /
+               kNofInstances << " ns" << std::endl;
+}
+
+}  // namespace workflow::test
@@ -0,0 +1,264 @@
+/*
+* Copyright 2024 Ingemar Hedvall
+* SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <util/syslogmessage.h>
+#include "workflow/workflowqueue.h"
+#include "workflow/workflowserver.h"
+#include "runsyslogschedule.h"
+#include "sysloginput.h"
+
+using namespace util::syslog;
+using namespace std::chrono_literals;
+
+namespace {
+
+class MockConsumerTask : public workflow::ITask {
+ public:
+  void Tick() override {
+    const auto* msg_list = GetWorkflow()->GetData<workflow::SyslogList>();
+    if (msg_list != nullptr) {
+      nof_messages += msg_list->size();
+    }
+    thread_id = std::this_thread::get_id();
+    IsOk(true);
+  }
+  std::atomic<size_t> nof_messages = 0;
+  std::thread::id thread_id;
+};
+
+}
+
+namespace workflow::test {
+
+TEST(WorkflowQueue, TestProperties) {
+  WorkflowQueue queue;
+  queue.Name("Queue1");
+  queue.Description("Test queue");
+  queue.Capacity(10);
+  queue.Policy(DropPolicy::DropOldest);
+  EXPECT_EQ(queue.Name(), "Queue1");
+  EXPECT_EQ(queue.Capacity(), 10);
+  EXPECT_EQ(queue.PolicyAsString(), "DropOldest");
+
+  queue.PolicyAsString("block");
+  EXPECT_EQ(queue.Policy(), DropPolicy::Block);
+
+  WorkflowQueue copy(queue);
+  EXPECT_TRUE(copy == queue);
+}
+
+TEST(WorkflowQueue, TestDropNewest) {
+  WorkflowQueue queue;
+  queue.Capacity(5);
+  EXPECT_FALSE(queue.Push(1)); // Not initialized
+  queue.Init();
+  EXPECT_TRUE(queue.Empty());
+
+  for (int item = 0; item < 8; ++item) {
+    queue.Push(item);
+  }
+  EXPECT_EQ(queue.Depth(), 5);
+  EXPECT_EQ(queue.MaxDepth(), 5);
+  EXPECT_EQ(queue.NofPushed(), 5);
+  EXPECT_EQ(queue.NofDropped(), 3);
+
+  for (int expected = 0; expected < 5; ++expected) {
+    int item = -1;
+    ASSERT_TRUE(queue.Pop(item));
+    EXPECT_EQ(item, expected);
+  }
+  int item = -1;
+  EXPECT_FALSE(queue.Pop(item));
+  EXPECT_EQ(queue.NofPopped(), 5);
+  queue.Exit();
+}
+
+TEST(WorkflowQueue, TestDropOldest) {
+  WorkflowQueue queue;
+  queue.Capacity(5);
+  queue.Policy(DropPolicy::DropOldest);
+  queue.Init();
+
+  for (int item = 0; item < 8; ++item) {
+    EXPECT_TRUE(queue.Push(item));
+  }
+  EXPECT_EQ(queue.Depth(), 5);
+  EXPECT_EQ(queue.NofDropped(), 3);
+
+  int item = -1;
+  ASSERT_TRUE(queue.Pop(item));
+  EXPECT_EQ(item, 3);
+
+  std::string wrong_type;
+  EXPECT_FALSE(queue.Pop(wrong_type));
+  queue.Exit();
+}
+
+TEST(WorkflowQueue, TestConcurrent) {
+  constexpr size_t kNofProducers = 4;
+  constexpr size_t kNofItems = 10'000;
+
+  WorkflowQueue queue;
+  queue.Capacity(64);
+  queue.Policy(DropPolicy::Block);
+  queue.Init();
+
+  std::atomic<bool> stop = false;
+  size_t sum = 0;
+  size_t count = 0;
+  std::thread consumer([&] {
+    uint64_t signal = 0;
+    while (count < kNofProducers * kNofItems) {
+      queue.WaitForItems(stop, signal);
+      for (size_t item = 0; queue.Pop(item); ) {
+        sum += item;
+        ++count;
+      }
+    }
+  });
+
+  std::vector<std::thread> producer_list;
+  for (size_t producer = 0; producer < kNofProducers; ++producer) {
+    producer_list.emplace_back([&] {
+      for (size_t item = 1; item <= kNofItems; ++item) {
+        queue.Push(item);
+      }
+    });
+  }
+  for (auto& producer : producer_list) {
+    producer.join();
+  }
+  consumer.join();
+
+  EXPECT_EQ(count, kNofProducers * kNofItems);
+  EXPECT_EQ(sum, kNofProducers * kNofItems * (kNofItems + 1) / 2);
+  EXPECT_EQ(queue.NofDropped(), 0);
+  EXPECT_LE(queue.MaxDepth(), 64);
+  queue.Exit();
+}
+
+TEST(WorkflowQueue, TestWaitForPush) {
+  WorkflowQueue queue;
+  queue.Init();
+  std::atomic<bool> stop = false;
+  uint64_t signal = 0;
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.WaitForItems(stop, signal));
+
+  // The item is left in the queue, so the consumer waits for the next push
+  std::atomic<bool> woken = false;
+  std::thread consumer([&] {
+    queue.WaitForItems(stop, signal);
+    woken = true;
+  });
+  std::this_thread::sleep_for(50ms);
+  EXPECT_FALSE(woken);
+  EXPECT_TRUE(queue.Push(2));
+  consumer.join();
+  EXPECT_TRUE(woken);
+  EXPECT_EQ(queue.Depth(), 2);
+  queue.Exit();
+}
+
+TEST(WorkflowQueue, TestBlockedProducer) {
+  WorkflowQueue queue;
+  queue.Capacity(2);
+  queue.Policy(DropPolicy::Block);
+  queue.Init();
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.Push(2));
+
+  std::atomic<bool> pushed = false;
+  std::thread producer([&] {
+    pushed = queue.Push(3);
+  });
+  std::this_thread::sleep_for(50ms);
+  EXPECT_FALSE(pushed);
+  int item = 0;
+  EXPECT_TRUE(queue.Pop(item));
+  producer.join();
+  EXPECT_TRUE(pushed);
+  EXPECT_EQ(queue.Depth(), 2);
+
+  // Exit() releases a blocked producer
+  std::thread blocked([&] {
+    pushed = queue.Push(4);
+  });
+  std::this_thread::sleep_for(50ms);
+  queue.Exit();
+  blocked.join();
+  EXPECT_FALSE(pushed);
+}
+
+TEST(WorkflowQueue, TestQueueEvent) {
+  WorkflowServer server;
+  WorkflowQueue queue_def;
+  queue_def.Name("SyslogQueue");
+  server.AddQueue(queue_def);
+
+  Event event_def;
+  event_def.Name("QueueEvent");
+  event_def.Type(EventType::Queue);
+  event_def.Parameter("SyslogQueue");
+  EXPECT_EQ(event_def.EventTypeAsString(), "Queue Event");
+  server.GetEventEngine()->AddEvent(event_def);
+
+  Workflow consumer_def(&server);
+  consumer_def.Name("Consumer");
+  consumer_def.StartEvent("QueueEvent");
+  server.AddWorkflow(consumer_def);
+  auto* consumer = server.GetWorkflow("Consumer");
+  ASSERT_TRUE(consumer != nullptr);
+  auto temp_input = std::make_unique<SyslogInput>();
+  auto* input = temp_input.get();
+  temp_input->Arguments("--queue=SyslogQueue");
+  consumer->Tasks().emplace_back(std::move(temp_input));
+  auto temp_task = std::make_unique<MockConsumerTask>();
+  auto* consumer_task = temp_task.get();
+  consumer->Tasks().emplace_back(std::move(temp_task));
+
+  Workflow producer_def(&server);
+  producer_def.Name("Producer");
+  server.AddWorkflow(producer_def);
+  auto* producer = server.GetWorkflow("Producer");
+  ASSERT_TRUE(producer != nullptr);
+  auto temp_forward = std::make_unique<RunSyslogSchedule>();
+  auto* forward = temp_forward.get();
+  temp_forward->Arguments("--queue=SyslogQueue");
+  producer->Tasks().emplace_back(std::move(temp_forward));
+
+  consumer->Init();
+  input->Init();
+  EXPECT_TRUE(input->IsOk());
+  producer->Init();
+  forward->Init();
+  server.Init();
+  EXPECT_TRUE(producer->InitData(SyslogList(10)));
+
+  producer->Tick();
+  EXPECT_TRUE(forward->IsOk()) << forward->LastError();
+  EXPECT_TRUE(producer->GetData<SyslogList>()->empty());
+  for (size_t wait = 0; wait < 100 && consumer_task->nof_messages < 10;
+       ++wait) {
+    std::this_thread::sleep_for(10ms);
+  }
+  server.Exit();
+  input->Exit();
+
+  EXPECT_EQ(consumer_task->nof_messages, 10);
+  EXPECT_NE(consumer_task->thread_id, std::this_thread::get_id());
+  const auto* queue = server.GetQueue("syslogqueue");
+  ASSERT_TRUE(queue != nullptr);
+  EXPECT_EQ(queue->NofPushed(), 10);
+  EXPECT_EQ(queue->NofPopped(), 10);
+}
+
+}  // namespace workflow::test
@@ -3,6 +3,11 @@
 * SPDX-License-Identifier: MIT
  */
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
 #include "workflow/workflowserver.h"
 #include <util/stringutil.h>
 
@@ -44,4 +49,66 @@ TEST(WorkflowServer, Compare) {
    */
 }
 
-}
\ No newline at end of file
+
+TEST(WorkflowServer, TestLookup) {
+  constexpr size_t kNofWorkflows = 10'000;
+  constexpr size_t kNofLookups = 100'000;
+
+  WorkflowServer server;
+  std::vector<std::string> name_list;
+  for (size_t index = 0; index < kNofWorkflows; ++index) {
+    auto workflow = std::make_unique<Workflow>(&server);
+    workflow->Name("Workflow_" + std::to_string(index));
+    name_list.emplace_back("WORKFLOW_" + std::to_string(index));
+    server.Workflows().emplace_back(std::move(workflow));
+  }
+  server.Init();
+
+  size_t nof_found = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t lookup = 0; lookup < kNofLookups; ++lookup) {
+    const auto& name = name_list[(lookup * 7919) % kNofWorkflows];
+    nof_found += server.GetWorkflow(name) != nullptr ? 1 : 0;
+  }
+  const auto indexed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(nof_found, kNofLookups);
+
+  // Reference: linear case-insensitive scan (the old lookup)
+  nof_found = 0;
+  const auto& workflow_list = server.Workflows();
+  const auto scan_start = std::chrono::steady_clock::now();
+  for (size_t lookup = 0; lookup < kNofLookups / 100; ++lookup) {
+    const auto& name = name_list[(lookup * 7919) % kNofWorkflows];
+    const auto itr = std::ranges::find_if(workflow_list,
+        [&] (const auto& workflow) {
+          return util::string::IEquals(name, workflow->Name());
+        });
+    nof_found += itr != workflow_list.cend() ? 1 : 0;
+  }
+  const auto scan = (std::chrono::steady_clock::now() - scan_start) * 100;
+  EXPECT_EQ(nof_found, kNofLookups / 100);
+
+  using std::chrono::nanoseconds;
+  std::cout << "Lookup (" << kNofWorkflows << " workflows) Indexed: "
+            << std::chrono::duration_cast<nanoseconds>(indexed).count() /
+               kNofLookups << " ns, Scan: "
+            << std::chrono::duration_cast<nanoseconds>(scan).count() /
+               kNofLookups << " ns" << std::endl;
+
+  // A miss is final as long as the index is up to date
+  const auto& const_server = server;
+  EXPECT_TRUE(const_server.GetWorkflow("Unknown") == nullptr);
+
+  // Renamed workflows are found without rebuilding the index
+  server.Workflows()[5]->Name("Renamed");
+  EXPECT_TRUE(server.GetWorkflow("Workflow_5") == nullptr);
+  EXPECT_EQ(server.GetWorkflow("renamed"), server.Workflows()[5].get());
+  EXPECT_TRUE(server.GetWorkflow("Unknown") == nullptr);
+
+  server.DeleteWorkflow(server.Workflows()[0].get());
+  EXPECT_TRUE(server.GetWorkflow("Workflow_0") == nullptr);
+  EXPECT_EQ(server.GetWorkflow("Renamed"), server.Workflows()[4].get());
+  server.Exit();
+}
+
+}  // namespace workflow::test